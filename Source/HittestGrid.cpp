@@ -1,1107 +1,1764 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "Input/HittestGrid.h"
-#include "Rendering/RenderingCommon.h"
-#include "SlateGlobals.h"
-#include "HAL/IConsoleManager.h"
-#include "Rendering/DrawElements.h"
-#include "Styling/CoreStyle.h"
-
-DEFINE_LOG_CATEGORY_STATIC(LogHittestDebug, Display, All);
-
-DECLARE_CYCLE_STAT(TEXT("HitTestGrid AddWidget"), STAT_SlateHTG_AddWidget, STATGROUP_Slate);
-DECLARE_CYCLE_STAT(TEXT("HitTestGrid RemoveWidget"), STAT_SlateHTG_RemoveWidget, STATGROUP_Slate);
-DECLARE_CYCLE_STAT(TEXT("HitTestGrid Clear"), STAT_SlateHTG_Clear, STATGROUP_Slate);
-DECLARE_CYCLE_STAT(TEXT("HitTestGrid GetCollapsedWidgets"), STAT_SlateHTG_GetCollapsedWidgets, STATGROUP_Slate);
-
-#define LOCTEXT_NAMESPACE "HittestGrid"
-#define UE_SLATE_HITTESTGRID_ARRAYSIZEMAX 0
-
-#if UE_SLATE_HITTESTGRID_ARRAYSIZEMAX
-int32 HittestGrid_CollapsedHittestGridArraySizeMax = 0;
-int32 HittestGrid_CollapsedWidgetsArraySizeMax = 0;
-#endif
-
-#if WITH_SLATE_DEBUGGING
-FHittestGrid::FDebuggingFindNextFocusableWidget FHittestGrid::OnFindNextFocusableWidgetExecuted;
-#endif //WITH_SLATE_DEBUGGING
-
-constexpr bool IsCompatibleUserIndex(int32 RequestedUserIndex, int32 TestUserIndex)
-{
-	// INDEX_NONE means the user index is compatible with all
-	return RequestedUserIndex == INDEX_NONE || TestUserIndex == INDEX_NONE|| RequestedUserIndex == TestUserIndex;
-}
-
-//
-// Helper Functions
-//
-
-FVector2D ClosestPointOnSlateRotatedRect(const FVector2D &Point, const FSlateRotatedRect& RotatedRect)
-{
-	//no need to do any testing if we are inside of the rect
-	if (RotatedRect.IsUnderLocation(Point))
-	{
-		return Point;
-	}
-
-	const static int32 NumOfCorners = 4;
-	FVector2D Corners[NumOfCorners];
-	Corners[0] = RotatedRect.TopLeft;
-	Corners[1] = Corners[0] + RotatedRect.ExtentX;
-	Corners[2] = Corners[1] + RotatedRect.ExtentY;
-	Corners[3] = Corners[0] + RotatedRect.ExtentY;
-
-	FVector2D RetPoint;
-	float ClosestDistSq = FLT_MAX;
-	for (int32 i = 0; i < NumOfCorners; ++i)
-	{
-		//grab the closest point along the line segment
-		const FVector2D ClosestPoint = FMath::ClosestPointOnSegment2D(Point, Corners[i], Corners[(i + 1) % NumOfCorners]);
-
-		//get the distance between the two
-		const float TestDist = FVector2D::DistSquared(Point, ClosestPoint);
-
-		//if the distance is smaller than the current smallest, update our closest
-		if (TestDist < ClosestDistSq)
-		{
-			RetPoint = ClosestPoint;
-			ClosestDistSq = TestDist;
-		}
-	}
-
-	return RetPoint;
-}
-
-FORCEINLINE float DistanceSqToSlateRotatedRect(const FVector2D &Point, const FSlateRotatedRect& RotatedRect)
-{
-	return FVector2D::DistSquared(ClosestPointOnSlateRotatedRect(Point, RotatedRect), Point);
-}
-
-FORCEINLINE bool IsOverlappingSlateRotatedRect(const FVector2D& Point, const float Radius, const FSlateRotatedRect& RotatedRect)
-{
-	return DistanceSqToSlateRotatedRect( Point, RotatedRect ) <= (Radius * Radius);
-}
-
-bool ContainsInteractableWidget(const TArray<FWidgetAndPointer>& PathToTest)
-{
-	for (int32 i = PathToTest.Num() - 1; i >= 0; --i)
-	{
-		const FWidgetAndPointer& WidgetAndPointer = PathToTest[i];
-		if (WidgetAndPointer.Widget->IsInteractable())
-		{
-			return true;
-		}
-	}
-	return false;
-}
-
-
-const FVector2D CellSize(128.0f, 128.0f);
-
-//
-// FHittestGrid::FWidgetIndex
-//
-const FHittestGrid::FWidgetData& FHittestGrid::FWidgetIndex::GetWidgetData() const
-{
-	check(Grid->WidgetArray.IsValidIndex(WidgetIndex));
-	return Grid->WidgetArray[WidgetIndex];
-}
-
-//
-// FHittestGrid::FGridTestingParams
-//
-struct FHittestGrid::FGridTestingParams
-{
-	/** Ctor */
-	FGridTestingParams()
-	: CellCoord(-1, -1)
-	, CursorPositionInGrid(FVector2D::ZeroVector)
-	, Radius(-1.0f)
-	, bTestWidgetIsInteractive(false)
-	{}
-
-	FIntPoint CellCoord;
-	FVector2D CursorPositionInGrid;
-	float Radius;
-	bool bTestWidgetIsInteractive;
-};
-
-//
-// FHittestGrid::FCell
-//
-
-void FHittestGrid::FCell::AddIndex(int32 WidgetIndex)
-{
-	check(!WidgetIndexes.Contains(WidgetIndex));
-	WidgetIndexes.Add(WidgetIndex);
-}
-
-void FHittestGrid::FCell::RemoveIndex(int32 WidgetIndex)
-{
-	WidgetIndexes.RemoveSingleSwap(WidgetIndex);
-}
-
-//
-// FHittestGrid
-//
-
-FHittestGrid::FHittestGrid()
-	: WidgetMap()
-	, WidgetArray()
-	, Cells()
-	, AppendedGridArray()
-	, Owner(nullptr)
-	, CullingRect()
-	, NumCells(0, 0)
-	, GridOrigin(0, 0)
-	, GridSize(0, 0)
-	, CurrentUserIndex(INDEX_NONE)
-{
-}
-
-TArray<FWidgetAndPointer> FHittestGrid::GetBubblePath(FVector2D DesktopSpaceCoordinate, float CursorRadius, bool bIgnoreEnabledStatus, int32 UserIndex)
-{
-	checkSlow(IsInGameThread());
-
-	const FVector2D CursorPositionInGrid = DesktopSpaceCoordinate - GridOrigin;
-
-	if (WidgetArray.Num() > 0 && Cells.Num() > 0)
-	{
-		FGridTestingParams TestingParams;
-		TestingParams.CursorPositionInGrid = CursorPositionInGrid;
-		TestingParams.CellCoord = GetCellCoordinate(CursorPositionInGrid);
-		TestingParams.Radius = 0.0f;
-		TestingParams.bTestWidgetIsInteractive = false;
-
-		// First add the exact point test results
-		const FIndexAndDistance BestHit = GetHitIndexFromCellIndex(TestingParams);
-		if (BestHit.IsValid())
-		{
-			const FWidgetData& BestHitWidgetData = BestHit.GetWidgetData();
-			const TSharedPtr<SWidget> FirstHitWidget = BestHitWidgetData.GetWidget();
-			// Make Sure we landed on a valid widget
-			if (FirstHitWidget.IsValid() && IsCompatibleUserIndex(UserIndex, BestHitWidgetData.UserIndex))
-			{
-				TArray<FWidgetAndPointer> Path;
-
-				TSharedPtr<SWidget> CurWidget = FirstHitWidget;
-				while (CurWidget.IsValid())
-				{
-					FGeometry DesktopSpaceGeometry = CurWidget->GetPaintSpaceGeometry();
-					DesktopSpaceGeometry.AppendTransform(FSlateLayoutTransform(GridOrigin - GridWindowOrigin));
-
-					Path.Emplace(FArrangedWidget(CurWidget.ToSharedRef(), DesktopSpaceGeometry), TSharedPtr<FVirtualPointerPosition>());
-					CurWidget = CurWidget->Advanced_GetPaintParentWidget();
-				}
-
-				if (!Path.Last().Widget->Advanced_IsWindow())
-				{
-					return TArray<FWidgetAndPointer>();
-				}
-
-				Algo::Reverse(Path);
-
-				bool bRemovedDisabledWidgets = false;
-				if (!bIgnoreEnabledStatus)
-				{
-					// @todo It might be more correct to remove all disabled widgets and non-hit testable widgets.  It doesn't make sense to have a hit test invisible widget as a leaf in the path
-					// and that can happen if we remove a disabled widget. Furthermore if we did this we could then append custom paths in all cases since the leaf most widget would be hit testable
-					// For backwards compatibility changing this could be risky
-					const int32 DisabledWidgetIndex = Path.IndexOfByPredicate([](const FArrangedWidget& SomeWidget) { return !SomeWidget.Widget->IsEnabled(); });
-					if (DisabledWidgetIndex != INDEX_NONE)
-					{
-						bRemovedDisabledWidgets = true;
-						Path.RemoveAt(DisabledWidgetIndex, Path.Num() - DisabledWidgetIndex);
-					}
-				}
-
-				if (!bRemovedDisabledWidgets && Path.Num() > 0)
-				{
-					if (BestHitWidgetData.CustomPath.IsValid())
-					{
-						const TArray<FWidgetAndPointer> BubblePathExtension = BestHitWidgetData.CustomPath.Pin()->GetBubblePathAndVirtualCursors(FirstHitWidget->GetTickSpaceGeometry(), DesktopSpaceCoordinate, bIgnoreEnabledStatus);
-						Path.Append(BubblePathExtension);
-					}
-				}
-	
-				return Path;
-			}
-		}
-	}
-
-	return TArray<FWidgetAndPointer>();
-}
-
-bool FHittestGrid::SetHittestArea(const FVector2D& HittestPositionInDesktop, const FVector2D& HittestDimensions, const FVector2D& HitestOffsetInWindow)
-{
-	bool bWasCleared = false;
-
-	// If the size of the hit test area changes we need to clear it out
-	if (GridSize != HittestDimensions)
-	{
-		GridSize = HittestDimensions;
-		NumCells = FIntPoint(FMath::CeilToInt(GridSize.X / CellSize.X), FMath::CeilToInt(GridSize.Y / CellSize.Y));
-		
-		const int32 NewTotalCells = NumCells.X * NumCells.Y;
-		ClearInternal(NewTotalCells);
-
-		bWasCleared = true;
-	}
-
-	GridOrigin = HittestPositionInDesktop;
-	GridWindowOrigin = HitestOffsetInWindow;
-
-	return bWasCleared;
-}
-
-void FHittestGrid::Clear()
-{
-	const int32 TotalCells = Cells.Num();
-	ClearInternal(TotalCells);
-}
-
-void FHittestGrid::ClearInternal(int32 TotalCells)
-{
-	SCOPE_CYCLE_COUNTER(STAT_SlateHTG_Clear);
-	Cells.Reset(TotalCells);
-	Cells.SetNum(TotalCells);
-
-	WidgetMap.Reset();
-	WidgetArray.Reset();
-    // HankShu-inkiu0@gmail.com add ClickClip Start
-	ClickClipMap.Reset();
-    // HankShu-inkiu0@gmail.com add ClickClip End
-	AppendedGridArray.Reset();
-}
-
-bool FHittestGrid::IsDescendantOf(const TSharedRef<SWidget> Parent, const FWidgetData& ChildData) const
-{
-	const TSharedPtr<SWidget> ChildWidgetPtr = ChildData.GetWidget();
-	if (ChildWidgetPtr == Parent)
-	{
-		return false;
-	}
-
-	const SWidget* ParentWidget = &Parent.Get();
-	const SWidget* CurWidget = ChildWidgetPtr.Get();
-
-	while (CurWidget)
-	{
-		if (ParentWidget == CurWidget)
-		{
-			return true;
-		}
-		CurWidget = CurWidget->Advanced_GetPaintParentWidget().Get();
-	}
-
-	return false;
-}
-
-#if WITH_SLATE_DEBUGGING
-namespace HittestGridDebuggingText
-{
-	static FText Valid = LOCTEXT("StateValid", "Valid"); //~ The widget is valid will be consider as the result
-	static FText NotCompatibleWithUserIndex = LOCTEXT("StateNotCompatibleWithUserIndex", "User Index not compatible"); //~ The widget is not compatible with the requested user index
-	static FText DoesNotIntersect = LOCTEXT("StateDoesNotIntersect", "Does not intersect"); //~ The widget rect is not in the correct direction or is not intersecting with the "swept" rectangle
-	static FText PreviousWidgetIsBetter = LOCTEXT("StatePreviousWidgetIsBetter", "Previous Widget was better"); //~ The widget would be valid but the previous valid is closer
-	static FText NotADescendant = LOCTEXT("StateNotADescendant", "Not a descendant"); //~ We have a non escape boundary condition and the widget isn't a descendant of our boundary
-	static FText Disabled = LOCTEXT("StateNotEnabled", "Disabled"); //~ The widget is not enabled
-	static FText DoesNotSuportKeyboardFocus = LOCTEXT("StateDoesNotSuportKeyboardFocus", "Keyboard focus unsupported"); //~ THe widget does not support keyboard focus
-}
-	#define AddToNextFocusableWidgetCondidateDebugResults(Candidate, Result) { if (IntermediateResultsPtr) { IntermediateResultsPtr->Emplace((Candidate), (Result)); } }
-#else
-	#define AddToNextFocusableWidgetCondidateDebugResults(Candidate, Result) CA_ASSUME(Candidate)
-#endif
-
-template<typename TCompareFunc, typename TSourceSideFunc, typename TDestSideFunc>
-TSharedPtr<SWidget> FHittestGrid::FindFocusableWidget(FSlateRect WidgetRect, const FSlateRect SweptRect, int32 AxisIndex, int32 Increment, const EUINavigation Direction, const FNavigationReply& NavigationReply, TCompareFunc CompareFunc, TSourceSideFunc SourceSideFunc, TDestSideFunc DestSideFunc, int32 UserIndex, TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult>* IntermediateResultsPtr) const
-{
-	FIntPoint CurrentCellPoint = GetCellCoordinate(WidgetRect.GetCenter());
-
-	int32 StartingIndex = CurrentCellPoint[AxisIndex];
-
-	float CurrentSourceSide = SourceSideFunc(WidgetRect);
-
-	int32 StrideAxis, StrideAxisMin, StrideAxisMax;
-
-	// Ensure that the hit test grid is valid before proceeding
-	if (NumCells.X < 1 || NumCells.Y < 1)
-	{
-		return TSharedPtr<SWidget>();
-	}
-
-	if (AxisIndex == 0)
-	{
-		StrideAxis = 1;
-		StrideAxisMin = FMath::Min(FMath::Max(FMath::FloorToInt(SweptRect.Top / CellSize.Y), 0), NumCells.Y - 1);
-		StrideAxisMax = FMath::Min(FMath::Max(FMath::FloorToInt(SweptRect.Bottom / CellSize.Y), 0), NumCells.Y - 1);
-	}
-	else
-	{
-		StrideAxis = 0;
-		StrideAxisMin = FMath::Min(FMath::Max(FMath::FloorToInt(SweptRect.Left / CellSize.X), 0), NumCells.X - 1);
-		StrideAxisMax = FMath::Min(FMath::Max(FMath::FloorToInt(SweptRect.Right / CellSize.X), 0), NumCells.X - 1);
-	}
-
-	bool bWrapped = false;
-	while (CurrentCellPoint[AxisIndex] >= 0 && CurrentCellPoint[AxisIndex] < NumCells[AxisIndex])
-	{
-		FIntPoint StrideCellPoint = CurrentCellPoint;
-		int32 CurrentCellProcessed = CurrentCellPoint[AxisIndex];
-
-		// Increment before the search as a wrap case will change our current cell.
-		CurrentCellPoint[AxisIndex] += Increment;
-
-		FSlateRect BestWidgetRect;
-		TSharedPtr<SWidget> BestWidget = TSharedPtr<SWidget>();
-
-		for (StrideCellPoint[StrideAxis] = StrideAxisMin; StrideCellPoint[StrideAxis] <= StrideAxisMax; ++StrideCellPoint[StrideAxis])
-		{
-			FCollapsedWidgetsArray WidgetIndexes;
-			GetCollapsedWidgets(WidgetIndexes, StrideCellPoint.X, StrideCellPoint.Y);
-
-			for (int32 i = WidgetIndexes.Num() - 1; i >= 0; --i)
-			{
-				const FWidgetData& TestCandidate = WidgetIndexes[i].GetWidgetData();
-				const TSharedPtr<SWidget> TestWidget = TestCandidate.GetWidget();
-				if (!TestWidget.IsValid())
-				{
-					continue;
-				}
-
-				if (!IsCompatibleUserIndex(UserIndex, TestCandidate.UserIndex))
-				{
-					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::NotCompatibleWithUserIndex);
-					continue;
-				}
-
-				FGeometry TestCandidateGeo = TestWidget->GetPaintSpaceGeometry();
-				TestCandidateGeo.AppendTransform(FSlateLayoutTransform(-GridWindowOrigin));
-				const FSlateRect TestCandidateRect = TestCandidateGeo.GetRenderBoundingRect();
-				if (!(CompareFunc(DestSideFunc(TestCandidateRect), CurrentSourceSide) && FSlateRect::DoRectanglesIntersect(SweptRect, TestCandidateRect)))
-				{
-					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::DoesNotIntersect);
-					continue;
-				}
-
-				// If this found widget isn't closer then the previously found widget then keep looking.
-				if (BestWidget.IsValid() && !CompareFunc(DestSideFunc(BestWidgetRect), DestSideFunc(TestCandidateRect)))
-				{
-					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::PreviousWidgetIsBetter);
-					continue;
-				}
-
-				// If we have a non escape boundary condition and this widget isn't a descendant of our boundary condition widget then it's invalid so we keep looking.
-				if (NavigationReply.GetBoundaryRule() != EUINavigationRule::Escape
-					&& NavigationReply.GetHandler().IsValid()
-					&& !IsDescendantOf(NavigationReply.GetHandler().ToSharedRef(), TestCandidate))
-				{
-					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::NotADescendant);
-					continue;
-				}
-
-				if (!TestWidget->IsEnabled())
-				{
-					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::Disabled);
-					continue;
-				}
-				
-				if (!TestWidget->SupportsKeyboardFocus())
-				{
-					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::DoesNotSuportKeyboardFocus);
-					continue;
-				}
-
-				BestWidgetRect = TestCandidateRect;
-				BestWidget = TestWidget;
-				AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::Valid);
-			}
-		}
-
-		if (BestWidget.IsValid())
-		{
-			// Check for the need to apply our rule
-			if (CompareFunc(DestSideFunc(BestWidgetRect), SourceSideFunc(SweptRect)))
-			{
-				switch (NavigationReply.GetBoundaryRule())
-				{
-				case EUINavigationRule::Explicit:
-					return NavigationReply.GetFocusRecipient();
-				case EUINavigationRule::Custom:
-				case EUINavigationRule::CustomBoundary:
-				{
-					const FNavigationDelegate& FocusDelegate = NavigationReply.GetFocusDelegate();
-					if (FocusDelegate.IsBound())
-					{
-						return FocusDelegate.Execute(Direction);
-					}
-					return TSharedPtr<SWidget>();
-				}
-				case EUINavigationRule::Stop:
-					return TSharedPtr<SWidget>();
-				case EUINavigationRule::Wrap:
-					CurrentSourceSide = DestSideFunc(SweptRect);
-					FVector2D SampleSpot = WidgetRect.GetCenter();
-					SampleSpot[AxisIndex] = CurrentSourceSide;
-					CurrentCellPoint = GetCellCoordinate(SampleSpot);
-					bWrapped = true;
-					break;
-				}
-			}
-
-			return BestWidget;
-		}
-
-		// break if we have looped back to where we started.
-		if (bWrapped && StartingIndex == CurrentCellProcessed) { break; }
-
-		// If were going to fail our bounds check and our rule is to a boundary condition (Wrap or CustomBoundary) handle appropriately
-		if (!(CurrentCellPoint[AxisIndex] >= 0 && CurrentCellPoint[AxisIndex] < NumCells[AxisIndex]))
-		{
-			if (NavigationReply.GetBoundaryRule() == EUINavigationRule::Wrap)
-			{
-				if (bWrapped)
-				{
-					// If we've already wrapped, unfortunately it must be that the starting widget wasn't within the boundary
-					break;
-				}
-				CurrentSourceSide = DestSideFunc(SweptRect);
-				FVector2D SampleSpot = WidgetRect.GetCenter();
-				SampleSpot[AxisIndex] = CurrentSourceSide;
-				CurrentCellPoint = GetCellCoordinate(SampleSpot);
-				bWrapped = true;
-			}
-			else if (NavigationReply.GetBoundaryRule() == EUINavigationRule::CustomBoundary)
-			{
-				const FNavigationDelegate& FocusDelegate = NavigationReply.GetFocusDelegate();
-				if (FocusDelegate.IsBound())
-				{
-					return FocusDelegate.Execute(Direction);
-				}
-			}
-		}
-	}
-
-	return TSharedPtr<SWidget>();
-}
-
-#undef AddToNextFocusableWidgetCondidateDebugResults
-
-TSharedPtr<SWidget> FHittestGrid::FindNextFocusableWidget(const FArrangedWidget& StartingWidget, const EUINavigation Direction, const FNavigationReply& NavigationReply, const FArrangedWidget& RuleWidget, int32 UserIndex)
-{
-	FGeometry StartingWidgetGeo = StartingWidget.Widget->GetPaintSpaceGeometry();
-	StartingWidgetGeo.AppendTransform(FSlateLayoutTransform(-GridWindowOrigin));
-	FSlateRect WidgetRect = StartingWidgetGeo.GetRenderBoundingRect();
-
-	FGeometry BoundingRuleWidgetGeo = RuleWidget.Widget->GetPaintSpaceGeometry();
-	BoundingRuleWidgetGeo.AppendTransform(FSlateLayoutTransform(-GridWindowOrigin));
-	FSlateRect BoundingRuleRect = BoundingRuleWidgetGeo.GetRenderBoundingRect();
-
-	FSlateRect SweptWidgetRect = WidgetRect;
-
-	TSharedPtr<SWidget> Widget = TSharedPtr<SWidget>();
-
-#if WITH_SLATE_DEBUGGING
-	TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult> IntermediateResults;
-	TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult>* IntermediateResultsPtr = OnFindNextFocusableWidgetExecuted.IsBound() ? &IntermediateResults : nullptr;
-#else
-	TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult>* IntermediateResultsPtr = nullptr;
-#endif
-
-	switch (Direction)
-	{
-	case EUINavigation::Left:
-		SweptWidgetRect.Left = BoundingRuleRect.Left;
-		SweptWidgetRect.Right = BoundingRuleRect.Right;
-		SweptWidgetRect.Top += 0.5f;
-		SweptWidgetRect.Bottom -= 0.5f;
-		Widget = FindFocusableWidget(WidgetRect, SweptWidgetRect, 0, -1, Direction, NavigationReply,
-			[](float A, float B) { return A - 0.1f < B; }, // Compare function
-			[](FSlateRect SourceRect) { return SourceRect.Left; }, // Source side function
-			[](FSlateRect DestRect) { return DestRect.Right; }, // Dest side function
-			UserIndex, IntermediateResultsPtr);
-		break;
-	case EUINavigation::Right:
-		SweptWidgetRect.Left = BoundingRuleRect.Left;
-		SweptWidgetRect.Right = BoundingRuleRect.Right;
-		SweptWidgetRect.Top += 0.5f;
-		SweptWidgetRect.Bottom -= 0.5f;
-		Widget = FindFocusableWidget(WidgetRect, SweptWidgetRect, 0, 1, Direction, NavigationReply,
-			[](float A, float B) { return A + 0.1f > B; }, // Compare function
-			[](FSlateRect SourceRect) { return SourceRect.Right; }, // Source side function
-			[](FSlateRect DestRect) { return DestRect.Left; }, // Dest side function
-			UserIndex, IntermediateResultsPtr);
-		break;
-	case EUINavigation::Up:
-		SweptWidgetRect.Top = BoundingRuleRect.Top;
-		SweptWidgetRect.Bottom = BoundingRuleRect.Bottom;
-		SweptWidgetRect.Left += 0.5f;
-		SweptWidgetRect.Right -= 0.5f;
-		Widget = FindFocusableWidget(WidgetRect, SweptWidgetRect, 1, -1, Direction, NavigationReply,
-			[](float A, float B) { return A - 0.1f < B; }, // Compare function
-			[](FSlateRect SourceRect) { return SourceRect.Top; }, // Source side function
-			[](FSlateRect DestRect) { return DestRect.Bottom; }, // Dest side function
-			UserIndex, IntermediateResultsPtr);
-		break;
-	case EUINavigation::Down:
-		SweptWidgetRect.Top = BoundingRuleRect.Top;
-		SweptWidgetRect.Bottom = BoundingRuleRect.Bottom;
-		SweptWidgetRect.Left += 0.5f;
-		SweptWidgetRect.Right -= 0.5f;
-		Widget = FindFocusableWidget(WidgetRect, SweptWidgetRect, 1, 1, Direction, NavigationReply,
-			[](float A, float B) { return A + 0.1f > B; }, // Compare function
-			[](FSlateRect SourceRect) { return SourceRect.Bottom; }, // Source side function
-			[](FSlateRect DestRect) { return DestRect.Top; }, // Dest side function
-			UserIndex, IntermediateResultsPtr);
-		break;
-
-	default:
-		break;
-	}
-
-#if WITH_SLATE_DEBUGGING
-	if (IntermediateResultsPtr)
-	{
-		FDebuggingFindNextFocusableWidgetArgs Args {StartingWidget, Direction, NavigationReply, RuleWidget, UserIndex, Widget , MoveTemp(*IntermediateResultsPtr)};
-		OnFindNextFocusableWidgetExecuted.Broadcast(this, Args);
-	}
-#endif
-
-	return Widget;
-}
-
-FIntPoint FHittestGrid::GetCellCoordinate(FVector2D Position) const
-{
-	return FIntPoint(
-		FMath::Min(FMath::Max(FMath::FloorToInt(Position.X / CellSize.X), 0), NumCells.X - 1),
-		FMath::Min(FMath::Max(FMath::FloorToInt(Position.Y / CellSize.Y), 0), NumCells.Y - 1));
-}
-
-bool FHittestGrid::IsValidCellCoord(const FIntPoint& CellCoord) const
-{
-	return IsValidCellCoord(CellCoord.X, CellCoord.Y);
-}
-
-bool FHittestGrid::IsValidCellCoord(const int32 XCoord, const int32 YCoord) const
-{
-	return XCoord >= 0 && XCoord < NumCells.X && YCoord >= 0 && YCoord < NumCells.Y;
-}
-
-void FHittestGrid::AddGrid(const TSharedRef<const FHittestGrid>& OtherGrid)
-{
-	auto GetCollapsedHittestGrid_NoTests = [](const FHittestGrid* HittestGrid, FCollapsedHittestGridArray& OutResult)
-	{
-		OutResult.Add(HittestGrid);
-		for (int32 Index = 0; Index < OutResult.Num(); ++Index)
-		{
-			for (const FAppendedGridData& AppendedGridData : OutResult[Index]->AppendedGridArray)
-			{
-				if (const TSharedPtr<const FHittestGrid> Grid = AppendedGridData.Grid.Pin())
-				{
-					OutResult.Add(Grid.Get());
-				}
-			}
-		}
-	};
-
-	const bool bIsContains = AppendedGridArray.ContainsByPredicate([OtherGrid](const FAppendedGridData& Other) { return Other.Grid == OtherGrid; });
-	if (ensure(CanBeAppended(&OtherGrid.Get())))
-	{
-		if (!bIsContains)
-		{
-			// Check for recursion
-			FCollapsedHittestGridArray AllHittestGrid;
-			GetCollapsedHittestGrid_NoTests(this, AllHittestGrid); // we are building a new array, do not perform size check
-			const bool bIsInCollapsed = AllHittestGrid.ContainsByPredicate([OtherGrid](const FHittestGrid* Other) { return &*OtherGrid == Other; });
-			ensure(!bIsInCollapsed);
-			if (bIsInCollapsed)
-			{
-				return;
-			}
-
-			AppendedGridArray.Emplace(OtherGrid->Owner, OtherGrid);
-		}
-	}
-	else
-	{
-		RemoveGrid(OtherGrid);
-	}
-}
-
-void FHittestGrid::RemoveGrid(const TSharedRef<const FHittestGrid>& OtherGrid)
-{
-	const int32 AppendedGridIndex = AppendedGridArray.IndexOfByPredicate(
-		[OtherGrid](const FAppendedGridData& Other)
-		{
-			return Other.Grid == OtherGrid;
-		});
-	if (AppendedGridIndex != INDEX_NONE)
-	{
-		AppendedGridArray.RemoveAtSwap(AppendedGridIndex);
-	}
-}
-
-void FHittestGrid::RemoveGrid(const SWidget* OtherGridOwner)
-{
-	const int32 AppendedGridIndex = AppendedGridArray.IndexOfByPredicate(
-		[OtherGridOwner](const FAppendedGridData& Other)
-		{
-			return Other.CachedOwner == OtherGridOwner;
-		});
-	if (AppendedGridIndex != INDEX_NONE)
-	{
-#if WITH_SLATE_DEBUGGING
-		// Confirmed that the cached grid is valid
-		if (const TSharedPtr<const FHittestGrid> Pin = AppendedGridArray[AppendedGridIndex].Grid.Pin())
-		{
-			ensure(Pin->Owner == OtherGridOwner);
-		}
-#endif
-		AppendedGridArray.RemoveAtSwap(AppendedGridIndex);
-	}
-}
-
-bool FHittestGrid::CanBeAppended(const FHittestGrid* OtherGrid) const
-{
-	return OtherGrid && OtherGrid->Owner && this != OtherGrid && SameSize(OtherGrid);
-}
-
-bool FHittestGrid::SameSize(const FHittestGrid* OtherGrid) const
-{
-	return GridOrigin == OtherGrid->GridOrigin && GridWindowOrigin == OtherGrid->GridWindowOrigin && GridSize == OtherGrid->GridSize;
-}
-
-void FHittestGrid::AddWidget(const TSharedRef<SWidget>& InWidget, int32 InBatchPriorityGroup, int32 InLayerId, int32 InSecondarySort)
-{
-	if (!InWidget->GetVisibility().IsHitTestVisible())
-	{
-		return;
-	}
-
-	SCOPE_CYCLE_COUNTER(STAT_SlateHTG_AddWidget);
-
-	// Track the widget and identify it's Widget Index
-	FGeometry GridSpaceGeometry = InWidget->GetPaintSpaceGeometry();
-	GridSpaceGeometry.AppendTransform(FSlateLayoutTransform(-GridWindowOrigin));
-
-	// Currently using grid offset because the grid covers all desktop space.
-	const FSlateRect BoundingRect = GridSpaceGeometry.GetRenderBoundingRect();
-
-	// Starting and ending cells covered by this widget.	
-	const FIntPoint UpperLeftCell = GetCellCoordinate(BoundingRect.GetTopLeft());
-	const FIntPoint LowerRightCell = GetCellCoordinate(BoundingRect.GetBottomRight());
-
-	const int64 PrimarySort = (((int64)InBatchPriorityGroup << 32) | InLayerId);
-
-	bool bAddWidget = true;
-	if (int32* FoundIndex = WidgetMap.Find(&*InWidget))
-	{
-		FWidgetData& WidgetData = WidgetArray[*FoundIndex];
-		if (WidgetData.UpperLeftCell != UpperLeftCell || WidgetData.LowerRightCell != LowerRightCell)
-		{
-			// Need to be updated
-			RemoveWidget(InWidget);
-		}
-		else
-		{
-			// Only update
-			bAddWidget = false;
-			WidgetData.PrimarySort = PrimarySort;
-			WidgetData.SecondarySort = InSecondarySort;
-			WidgetData.UserIndex = CurrentUserIndex;
-		}
-	}
-
-	if (bAddWidget)
-	{
-		int32& WidgetIndex = WidgetMap.Add(&*InWidget);
-		WidgetIndex = WidgetArray.Emplace(InWidget, UpperLeftCell, LowerRightCell, PrimarySort, InSecondarySort, CurrentUserIndex);
-		for (int32 XIndex = UpperLeftCell.X; XIndex <= LowerRightCell.X; ++XIndex)
-		{
-			for (int32 YIndex = UpperLeftCell.Y; YIndex <= LowerRightCell.Y; ++YIndex)
-			{
-				if (IsValidCellCoord(XIndex, YIndex))
-				{
-					CellAt(XIndex, YIndex).AddIndex(WidgetIndex);
-				}
-			}
-		}
-	}
-}
-
-void FHittestGrid::RemoveWidget(const TSharedRef<SWidget>& InWidget)
-{
-	RemoveWidget(&*InWidget);
-}
-
-void FHittestGrid::RemoveWidget(const SWidget* InWidget)
-{
-	SCOPE_CYCLE_COUNTER(STAT_SlateHTG_RemoveWidget);
-
-	int32 WidgetIndex = INDEX_NONE;
-	if (WidgetMap.RemoveAndCopyValue(InWidget, WidgetIndex))
-	{
-		const FWidgetData& WidgetData = WidgetArray[WidgetIndex];
-
-		// Starting and ending cells covered by this widget.	
-		const FIntPoint& UpperLeftCell = WidgetData.UpperLeftCell;
-		const FIntPoint& LowerRightCell = WidgetData.LowerRightCell;
-
-		for (int32 XIndex = UpperLeftCell.X; XIndex <= LowerRightCell.X; ++XIndex)
-		{
-			for (int32 YIndex = UpperLeftCell.Y; YIndex <= LowerRightCell.Y; ++YIndex)
-			{
-				checkSlow(IsValidCellCoord(XIndex, YIndex));
-				CellAt(XIndex, YIndex).RemoveIndex(WidgetIndex);
-			}
-		}
-
-		WidgetArray.RemoveAt(WidgetIndex);
-	}
-
-	RemoveGrid(InWidget);
-}
-
-void FHittestGrid::InsertCustomHitTestPath(const TSharedRef<SWidget> InWidget, TSharedRef<ICustomHitTestPath> CustomHitTestPath)
-{
-	int32 WidgetIndex = WidgetMap.FindChecked(&*InWidget);
-	FWidgetData& WidgetData = WidgetArray[WidgetIndex];
-	WidgetData.CustomPath = CustomHitTestPath;
-}
-
-FHittestGrid::FIndexAndDistance FHittestGrid::GetHitIndexFromCellIndex(const FGridTestingParams& Params) const
-{
-	//check if the cell coord 
-	if (IsValidCellCoord(Params.CellCoord))
-	{
-		// Get the cell and sort it 
-		FCollapsedWidgetsArray WidgetIndexes;
-		GetCollapsedWidgets(WidgetIndexes, Params.CellCoord.X, Params.CellCoord.Y);
-
-#if 0 //Unroll some data for debugging if necessary
-		struct FDebugData
-		{
-			FWidgetData WidgetData;
-			FName WidgetType;
-			FName WidgetLoc;
-			TSharedPtr<SWidget> Widget;
-		};
-
-		TArray<FDebugData> DebugData;
-		for (int32 i = 0; i < WidgetIndexes.Num(); ++i)
-		{
-			FDebugData& Cur = DebugData.AddDefaulted_GetRef();
-			Cur.WidgetData = WidgetIndexes[i].GetWidgetData();
-			Cur.Widget = Cur.WidgetData.GetWidget();
-			Cur.WidgetType = Cur.Widget.IsValid() ? Cur.Widget->GetType() : NAME_None;
-			Cur.WidgetLoc = Cur.Widget.IsValid() ? Cur.Widget->GetCreatedInLocation() : NAME_None;
-		}
-#endif
-
-		// Consider front-most widgets first for hittesting.
-		for (int32 i = WidgetIndexes.Num() - 1; i >= 0; --i)
-		{
-			check(WidgetIndexes[i].IsValid());
-			const FWidgetData& TestCandidate = WidgetIndexes[i].GetWidgetData();
-			const TSharedPtr<SWidget> TestWidget = TestCandidate.GetWidget();
-
-			// When performing a point hittest, accept all hittestable widgets.
-			// When performing a hittest with a radius, only grab interactive widgets.
-			const bool bIsValidWidget = TestWidget.IsValid() && (!Params.bTestWidgetIsInteractive || TestWidget->IsInteractable());
-			if (bIsValidWidget)
-			{
-				const FVector2D WindowSpaceCoordinate = Params.CursorPositionInGrid + GridWindowOrigin;
-
-				const FGeometry& TestGeometry = TestWidget->GetPaintSpaceGeometry();
-
-				bool bPointInsideClipMasks = true;
-
-				if (WidgetIndexes[i].GetCullingRect().IsValid())
-				{
-					bPointInsideClipMasks = WidgetIndexes[i].GetCullingRect().ContainsPoint(WindowSpaceCoordinate);
-				}
-
-				if (bPointInsideClipMasks)
-				{
-					const TOptional<FSlateClippingState>& WidgetClippingState = TestWidget->GetCurrentClippingState();
-					if (WidgetClippingState.IsSet())
-					{
-						// TODO: Solve non-zero radius cursors?
-						bPointInsideClipMasks = WidgetClippingState->IsPointInside(WindowSpaceCoordinate);
-					}
-				}
-
-				// HankShu-inkiu0@gmail.com add ClickClip Start
-				bool IsClickThrough = IsThroughClickClip(Params, TestWidget.Get());
-				if (bPointInsideClipMasks && !IsClickThrough)
-				// HankShu-inkiu0@gmail.com add ClickClip End
-				{
-					// Compute the render space clipping rect (FGeometry exposes a layout space clipping rect).
-					const FSlateRotatedRect WindowOrientedClipRect = TransformRect(
-						Concatenate(
-							Inverse(TestGeometry.GetAccumulatedLayoutTransform()),
-							TestGeometry.GetAccumulatedRenderTransform()),
-						FSlateRotatedRect(TestGeometry.GetLayoutBoundingRect())
-					);
-
-					if (IsOverlappingSlateRotatedRect(WindowSpaceCoordinate, Params.Radius, WindowOrientedClipRect))
-					{
-						// For non-0 radii also record the distance to cursor's center so that we can pick the closest hit from the results.
-						const bool bNeedsDistanceSearch = Params.Radius > 0.0f;
-						const float DistSq = (bNeedsDistanceSearch) ? DistanceSqToSlateRotatedRect(WindowSpaceCoordinate, WindowOrientedClipRect) : 0.0f;
-						return FIndexAndDistance(WidgetIndexes[i], DistSq);
-					}
-				}
-			}
-		}
-	}
-
-	return FIndexAndDistance();
-}
-
- void FHittestGrid::GetCollapsedHittestGrid(FCollapsedHittestGridArray& OutResult) const
-{
-	OutResult.Add(this);
-	for (const FAppendedGridData& AppendedGridData : AppendedGridArray)
-	{
-		if (const TSharedPtr<const FHittestGrid>& AppendedGrid = AppendedGridData.Grid.Pin())
-		{
-			if (ensure(!OutResult.Contains(AppendedGrid.Get()))) // Check for recursion
-			{
-				if (ensure(SameSize(AppendedGrid.Get())))
-				{
-					AppendedGrid->GetCollapsedHittestGrid(OutResult);
-				}
-			}
-		}
-	}
-
-#if UE_SLATE_HITTESTGRID_ARRAYSIZEMAX
-	HittestGrid_CollapsedHittestGridArraySizeMax = FMath::Max(OutResult.Num(), HittestGrid_CollapsedHittestGridArraySizeMax);
-#endif
-}
-
-#define UE_VERIFY_WIDGET_VALIDITE 0
- void FHittestGrid::GetCollapsedWidgets(FCollapsedWidgetsArray& OutResult, const int32 X, const int32 Y) const
- {
-	 SCOPE_CYCLE_COUNTER(STAT_SlateHTG_GetCollapsedWidgets);
-
-	 const int32 CellIndex = Y * NumCells.X + X;
-	 check(Cells.IsValidIndex(CellIndex));
-
-	 FCollapsedHittestGridArray AllHitTestGrids;
-	 GetCollapsedHittestGrid(AllHitTestGrids);
-
-	 // N.B. it would be more efficient if we only rebuild if the cell has changed
-	 //but the PrimarySort and SecondaySort are not updated directly and the cell doesn't know about it
-
-	 {
-		 for (const FHittestGrid* HittestGrid : AllHitTestGrids)
-		 {
-			 const TArray<int32>& WidgetsIndexes = HittestGrid->CellAt(X, Y).GetWidgetIndexes();
-			 for (int32 WidgetIndex : WidgetsIndexes)
-			 {
-#if UE_VERIFY_WIDGET_VALIDITE
-				 ensureAlways(HittestGrid->WidgetArray.IsValidIndex(WidgetIndex));
-#endif
-				 OutResult.Emplace(HittestGrid, WidgetIndex);
-			 }
-		 }
-
-		 OutResult.StableSort([](const FWidgetIndex& A, const FWidgetIndex& B)
-			 {
-				 const FWidgetData& WidgetDataA = A.GetWidgetData();
-				 const FWidgetData& WidgetDataB = B.GetWidgetData();
-				 return WidgetDataA.PrimarySort < WidgetDataB.PrimarySort || (WidgetDataA.PrimarySort == WidgetDataB.PrimarySort && WidgetDataA.SecondarySort < WidgetDataB.SecondarySort);
-			 });
-	 }
-
-#if UE_SLATE_HITTESTGRID_ARRAYSIZEMAX
-	 HittestGrid_CollapsedWidgetsArraySizeMax = FMath::Max(OutResult.Num(), HittestGrid_CollapsedWidgetsArraySizeMax);
-#endif
- }
-#undef UE_VERIFY_WIDGET_VALIDITE
-
-void FHittestGrid::RemoveStaleAppendedHittestGrid()
-{
-	for (int32 AppendedGridIndex = AppendedGridArray.Num() - 1; AppendedGridIndex >= 0; --AppendedGridIndex)
-	{
-		bool bToRemove = false;
-		const TWeakPtr<const FHittestGrid>& WeakAppendedGrid = AppendedGridArray[AppendedGridIndex].Grid;
-		if (const TSharedPtr<const FHittestGrid>& AppendedGrid = WeakAppendedGrid.Pin())
-		{
-			if (!SameSize(AppendedGrid.Get()))
-			{
-				bToRemove = true;
-			}
-		}
-		else
-		{
-			// grid was removed without notifying the SlateInvalidationRoot.
-			//That can happened when the widget containing the owner of the grid is removed in the same frame as it was added.
-			bToRemove = true;
-		}
-
-		if (bToRemove)
-		{
-			AppendedGridArray.RemoveAtSwap(AppendedGridIndex);
-		}
-	}
-}
-
-#if WITH_SLATE_DEBUGGING
-void FHittestGrid::LogGrid() const
-{
-	FString TempString;
-	for (int32 y = 0; y < NumCells.Y; ++y)
-	{
-		for (int x = 0; x < NumCells.X; ++x)
-		{
-			TempString += "\t";
-			TempString += "[";
-			for (int32 i : CellAt(x, y).GetWidgetIndexes())
-			{
-				TempString += FString::Printf(TEXT("%d,"), i);
-			}
-			TempString += "]";
-		}
-		TempString += "\n";
-	}
-
-	TempString += "\n";
-
-	UE_LOG(LogHittestDebug, Warning, TEXT("\n%s"), *TempString);
-
-	for (TSparseArray<FWidgetData>::TConstIterator It(WidgetArray); It; ++It)
-	{
-		const FWidgetData& CurWidgetData = *It;
-		const TSharedPtr<SWidget> CachedWidget = CurWidgetData.GetWidget();
-		UE_LOG(LogHittestDebug, Warning, TEXT("  [%d][%d][%d] => %s @ %s"),
-			It.GetIndex(),
-			CurWidgetData.PrimarySort,
-			CachedWidget.IsValid() ? *CachedWidget->ToString() : TEXT("Invalid Widget"),
-			CachedWidget.IsValid() ? *CachedWidget->GetPaintSpaceGeometry().ToString() : TEXT("Invalid Widget"));
-	}
-}
-
-constexpr FLinearColor GetUserColorFromIndex(int32 Index)
-{
-	switch (Index)
-	{
-	case 0:
-		return FLinearColor::Red;
-	case 1:
-		return FLinearColor::Green;
-	case 2:
-		return FLinearColor::Blue;
-	case 3:
-		return FLinearColor::Yellow;
-	default:
-		return FLinearColor::White;
-	}
-};
-
-
-void FHittestGrid::DisplayGrid(int32 InLayer, const FGeometry& AllottedGeometry, FSlateWindowElementList& WindowElementList, EDisplayGridFlags DisplayFlags) const
-{
-	static const FSlateBrush* FocusRectangleBrush = FCoreStyle::Get().GetBrush(TEXT("FocusRectangle"));
-	static const FSlateBrush* BorderBrush = FCoreStyle::Get().GetBrush(TEXT("Border"));
-
-	const FSlateBrush* Brush = EnumHasAnyFlags(DisplayFlags, EDisplayGridFlags::UseFocusBrush) ? FocusRectangleBrush : BorderBrush;
-
-	auto DisplayGrid = [&] (const FHittestGrid* HittestGrid)
-	{
-		for (TSparseArray<FWidgetData>::TConstIterator It(HittestGrid->WidgetArray); It; ++It)
-		{
-			const FWidgetData& CurWidgetData = *It;
-			const TSharedPtr<SWidget> CachedWidget = CurWidgetData.GetWidget();
-			if (ensure(CachedWidget.IsValid())) // Widget should always be valid
-			{
-				if (EnumHasAnyFlags(DisplayFlags, EDisplayGridFlags::HideDisabledWidgets) && !CachedWidget->IsEnabled())
-				{
-					continue;
-				}
-				if (EnumHasAnyFlags(DisplayFlags, EDisplayGridFlags::HideUnsupportedKeyboardFocusWidgets) && !CachedWidget->SupportsKeyboardFocus())
-				{
-					continue;
-				}
-
-				FSlateDrawElement::MakeBox(
-					WindowElementList,
-					InLayer,
-					CachedWidget->GetPaintSpaceGeometry().ToPaintGeometry(),
-					Brush,
-					ESlateDrawEffect::None,
-					GetUserColorFromIndex(CurWidgetData.UserIndex)
-				);
-			}
-		}
-	};
-
-	FCollapsedHittestGridArray AllHitTestGrids;
-	GetCollapsedHittestGrid(AllHitTestGrids);
-	for(const FHittestGrid* HittestGrid : AllHitTestGrids)
-	{
-		DisplayGrid(HittestGrid);
-	}
-
-	// Appended grid should always be valid
-	FCollapsedHittestGridArray TestHitTestGrids;
-	TestHitTestGrids.Add(this);
-	for (int32 Index = 0; Index < TestHitTestGrids.Num(); ++Index)
-	{
-		const FHittestGrid* Grid = TestHitTestGrids[Index];
-		for (const FAppendedGridData& OtherGridData : Grid->AppendedGridArray)
-		{
-			const TSharedPtr<const FHittestGrid> OtherGridPin = OtherGridData.Grid.Pin();
-			if (ensureAlways(OtherGridPin.IsValid()))
-			{
-				TestHitTestGrids.Add(&*OtherGridPin);
-			}
-		}
-	}
-}
-#endif // WITH_SLATE_DEBUGGING
-
-// HankShu-inkiu0@gmail.com add ClickClip Start
-
-void FHittestGrid::AddClickClip(const SWidget* InWidget, const TSharedPtr<FSlateClickClippingState>& InClickClip)
-{
-	if (!ClickClipMap.Contains(InWidget))
-	{
-		ClickClipMap.Add(InWidget);
-	}
-	ClickClipMap[InWidget].Add(InClickClip);
-}
-
-bool FHittestGrid::IsThroughClickClip(const FGridTestingParams& Params, const SWidget* ClickWidget) const
-{
-	if (ClickClipMap.Contains(ClickWidget))
-	{
-		uint8 HitClipNum = 0;
-		uint8 ThroughClipNum = 0;
-		TArray<TSharedPtr<FSlateClickClippingState>> ClickClips = ClickClipMap[ClickWidget];
-		for (uint8 i = 0; i < ClickClips.Num(); i++)
-		{
-			if (ClickClips[i]->IsPointInside(Params.CursorPositionInGrid + GridWindowOrigin))
-			{
-				HitClipNum++;
-				if (ClickClips[i]->IsClickThrough(Params.CursorPositionInGrid + GridWindowOrigin))
-				{
-					ThroughClipNum++;
-				}
-			}
-		}
-
-		if (HitClipNum > 0 && HitClipNum == ThroughClipNum)
-		{
-			return true;
-		}
-	}
-	return false;
-}
-
-// HankShu-inkiu0@gmail.com add ClickClip end
-
-#undef UE_SLATE_HITTESTGRID_ARRAYSIZEMAX
-#undef LOCTEXT_NAMESPACE
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Input/HittestGrid.h"
+#include "Rendering/RenderingCommon.h"
+#include "SlateGlobals.h"
+#include "HAL/IConsoleManager.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHittestDebug, Display, All);
+
+DECLARE_CYCLE_STAT(TEXT("HitTestGrid AddWidget"), STAT_SlateHTG_AddWidget, STATGROUP_Slate);
+DECLARE_CYCLE_STAT(TEXT("HitTestGrid RemoveWidget"), STAT_SlateHTG_RemoveWidget, STATGROUP_Slate);
+DECLARE_CYCLE_STAT(TEXT("HitTestGrid Clear"), STAT_SlateHTG_Clear, STATGROUP_Slate);
+DECLARE_CYCLE_STAT(TEXT("HitTestGrid GetCollapsedWidgets"), STAT_SlateHTG_GetCollapsedWidgets, STATGROUP_Slate);
+
+#define LOCTEXT_NAMESPACE "HittestGrid"
+#define UE_SLATE_HITTESTGRID_ARRAYSIZEMAX 0
+
+#if UE_SLATE_HITTESTGRID_ARRAYSIZEMAX
+int32 HittestGrid_CollapsedHittestGridArraySizeMax = 0;
+int32 HittestGrid_CollapsedWidgetsArraySizeMax = 0;
+#endif
+
+#if WITH_SLATE_DEBUGGING
+FHittestGrid::FDebuggingFindNextFocusableWidget FHittestGrid::OnFindNextFocusableWidgetExecuted;
+#endif //WITH_SLATE_DEBUGGING
+
+constexpr bool IsCompatibleUserIndex(int32 RequestedUserIndex, int32 TestUserIndex)
+{
+	// INDEX_NONE means the user index is compatible with all
+	return RequestedUserIndex == INDEX_NONE || TestUserIndex == INDEX_NONE|| RequestedUserIndex == TestUserIndex;
+}
+
+//
+// Helper Functions
+//
+
+FVector2D ClosestPointOnSlateRotatedRect(const FVector2D &Point, const FSlateRotatedRect& RotatedRect)
+{
+	//no need to do any testing if we are inside of the rect
+	if (RotatedRect.IsUnderLocation(Point))
+	{
+		return Point;
+	}
+
+	const static int32 NumOfCorners = 4;
+	FVector2D Corners[NumOfCorners];
+	Corners[0] = RotatedRect.TopLeft;
+	Corners[1] = Corners[0] + RotatedRect.ExtentX;
+	Corners[2] = Corners[1] + RotatedRect.ExtentY;
+	Corners[3] = Corners[0] + RotatedRect.ExtentY;
+
+	FVector2D RetPoint;
+	float ClosestDistSq = FLT_MAX;
+	for (int32 i = 0; i < NumOfCorners; ++i)
+	{
+		//grab the closest point along the line segment
+		const FVector2D ClosestPoint = FMath::ClosestPointOnSegment2D(Point, Corners[i], Corners[(i + 1) % NumOfCorners]);
+
+		//get the distance between the two
+		const float TestDist = FVector2D::DistSquared(Point, ClosestPoint);
+
+		//if the distance is smaller than the current smallest, update our closest
+		if (TestDist < ClosestDistSq)
+		{
+			RetPoint = ClosestPoint;
+			ClosestDistSq = TestDist;
+		}
+	}
+
+	return RetPoint;
+}
+
+FORCEINLINE float DistanceSqToSlateRotatedRect(const FVector2D &Point, const FSlateRotatedRect& RotatedRect)
+{
+	return FVector2D::DistSquared(ClosestPointOnSlateRotatedRect(Point, RotatedRect), Point);
+}
+
+FORCEINLINE bool IsOverlappingSlateRotatedRect(const FVector2D& Point, const float Radius, const FSlateRotatedRect& RotatedRect)
+{
+	return DistanceSqToSlateRotatedRect( Point, RotatedRect ) <= (Radius * Radius);
+}
+
+bool ContainsInteractableWidget(const TArray<FWidgetAndPointer>& PathToTest)
+{
+	for (int32 i = PathToTest.Num() - 1; i >= 0; --i)
+	{
+		const FWidgetAndPointer& WidgetAndPointer = PathToTest[i];
+		if (WidgetAndPointer.Widget->IsInteractable())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+int32 GSlateHitTestGridCellSize = 128;
+static FAutoConsoleVariableRef CVarSlateHitTestGridCellSize(
+	TEXT("Slate.HitTestGrid.CellSize"),
+	GSlateHitTestGridCellSize,
+	TEXT("Size in slate units of the hittest grid cells, applied when a grid is next resized."));
+
+int32 GSlateHitTestGridRootCellThreshold = 64;
+static FAutoConsoleVariableRef CVarSlateHitTestGridRootCellThreshold(
+	TEXT("Slate.HitTestGrid.RootCellThreshold"),
+	GSlateHitTestGridRootCellThreshold,
+	TEXT("Widgets covering at least that many cells are kept in a single list tested in every cell. 0 disables it."));
+
+//
+// FHittestGrid::FWidgetIndex
+//
+const FHittestGrid::FWidgetData& FHittestGrid::FWidgetIndex::GetWidgetData() const
+{
+	check(Grid->WidgetArray.IsValidIndex(WidgetIndex));
+	return Grid->WidgetArray[WidgetIndex];
+}
+
+//
+// FHittestGrid::FGridTestingParams
+//
+struct FHittestGrid::FGridTestingParams
+{
+	/** Ctor */
+	FGridTestingParams()
+	: CellCoord(-1, -1)
+	, CursorPositionInGrid(FVector2D::ZeroVector)
+	, Radius(-1.0f)
+	, bTestWidgetIsInteractive(false)
+	{}
+
+	FIntPoint CellCoord;
+	FVector2D CursorPositionInGrid;
+	float Radius;
+	bool bTestWidgetIsInteractive;
+};
+
+//
+// FHittestGrid::FCell
+//
+
+namespace HittestGridPrivate
+{
+	/** Cell versions come from a single counter so a cell never reuses the version of another cell, even one of a deleted grid at the same address */
+	uint32 NextCellVersion = 0;
+
+	uint32 MakeCellVersion()
+	{
+		checkSlow(IsInGameThread());
+		return ++NextCellVersion;
+	}
+
+	/** Bumped by any change of any grid that could change a hit result or a bubble path */
+	uint32 HittestGeneration = 0;
+
+	void MarkHittestChanged()
+	{
+		checkSlow(IsInGameThread());
+		++HittestGeneration;
+	}
+
+	/** Bumped when any grid is appended, removed, cleared or moved, the flattened lists of appended grids are then stale */
+	uint32 AppendedGridsGeneration = 1;
+
+	void MarkAppendedGridsChanged()
+	{
+		checkSlow(IsInGameThread());
+		++AppendedGridsGeneration;
+	}
+}
+
+void FHittestGrid::FCell::AddIndex(int32 WidgetIndex)
+{
+	check(!WidgetIndexes.Contains(WidgetIndex));
+	WidgetIndexes.Add(WidgetIndex);
+	Version = HittestGridPrivate::MakeCellVersion();
+}
+
+void FHittestGrid::FCell::RemoveIndex(int32 WidgetIndex)
+{
+	WidgetIndexes.RemoveSingleSwap(WidgetIndex);
+	Version = HittestGridPrivate::MakeCellVersion();
+}
+
+void FHittestGrid::FCell::MarkSortDirty()
+{
+	Version = HittestGridPrivate::MakeCellVersion();
+}
+
+//
+// FHittestGrid
+//
+
+FHittestGrid::FHittestGrid()
+	: WidgetMap()
+	, WidgetArray()
+	, Cells()
+	, AppendedGridArray()
+	, Owner(nullptr)
+	, CullingRect()
+	, NumCells(0, 0)
+	, CellSize(128.0f, 128.0f)
+	, GridOrigin(0, 0)
+	, GridSize(0, 0)
+	, CurrentUserIndex(INDEX_NONE)
+	, bNavigationEdgesDirty(true)
+{
+}
+
+//
+// FHittestGrid::FBubblePathCache
+//
+struct FHittestGrid::FBubblePathCache
+{
+	/** A widget already walked in this batch and the node of its paint parent */
+	struct FNode
+	{
+		FAncestorEntry Entry;
+		int32 ParentNode;
+	};
+
+	TArray<FNode> Nodes;
+	TMap<const SWidget*, int32> NodeMap;
+};
+
+TArray<FWidgetAndPointer> FHittestGrid::GetBubblePath(FVector2D DesktopSpaceCoordinate, float CursorRadius, bool bIgnoreEnabledStatus, int32 UserIndex)
+{
+	TArray<FWidgetAndPointer> Path;
+	GetBubblePathInternal(DesktopSpaceCoordinate, bIgnoreEnabledStatus, UserIndex, Path);
+	return Path;
+}
+
+void FHittestGrid::GetBubblePath(FVector2D DesktopSpaceCoordinate, float CursorRadius, bool bIgnoreEnabledStatus, int32 UserIndex, FBubblePathBuffer& OutPath)
+{
+	GetBubblePathInternal(DesktopSpaceCoordinate, bIgnoreEnabledStatus, UserIndex, OutPath);
+}
+
+template<typename AllocatorType>
+void FHittestGrid::GetBubblePathInternal(FVector2D DesktopSpaceCoordinate, bool bIgnoreEnabledStatus, int32 UserIndex, TArray<FWidgetAndPointer, AllocatorType>& OutPath)
+{
+	checkSlow(IsInGameThread());
+
+	OutPath.Reset();
+
+	const FVector2D CursorPositionInGrid = DesktopSpaceCoordinate - GridOrigin;
+
+	if (WidgetArray.Num() > 0 && Cells.Num() > 0)
+	{
+		FGridTestingParams TestingParams;
+		TestingParams.CursorPositionInGrid = CursorPositionInGrid;
+		TestingParams.CellCoord = GetCellCoordinate(CursorPositionInGrid);
+		TestingParams.Radius = 0.0f;
+		TestingParams.bTestWidgetIsInteractive = false;
+
+		const FCollapsedCell& CollapsedCell = GetCollapsedWidgets(TestingParams.CellCoord.X, TestingParams.CellCoord.Y);
+		const uint32 CollapsedVersion = CollapsedCell.BuildVersion;
+
+		// Nothing changed since the last hit in this cell, only the widgets in front of it can take the hit from it
+		const bool bHoverCacheValid = HoverCache.bValid
+			&& HoverCache.Generation == HittestGridPrivate::HittestGeneration
+			&& HoverCache.CollapsedVersion == CollapsedVersion
+			&& HoverCache.UserIndex == UserIndex
+			&& HoverCache.bIgnoreEnabledStatus == bIgnoreEnabledStatus;
+
+		const int32 LastCandidate = CollapsedCell.WidgetIndexes.Num() - 1;
+		int32 CandidatePosition = INDEX_NONE;
+		FIndexAndDistance BestHit;
+		if (bHoverCacheValid)
+		{
+			const int32 CachedPosition = HoverCache.CandidatePosition;
+			BestHit = GetHitIndexFromCandidates(TestingParams, CollapsedCell, CachedPosition + 1, LastCandidate, &CandidatePosition);
+			if (!BestHit.IsValid())
+			{
+				// Still the front-most hit, its path is the one built last time
+				if (GetHitIndexFromCandidates(TestingParams, CollapsedCell, CachedPosition, CachedPosition).IsValid() && IsHoverPathEnabled(bIgnoreEnabledStatus))
+				{
+					OutPath.Append(HoverCache.Path);
+					return;
+				}
+
+				// The cursor left the cached widget, test the widgets behind it
+				BestHit = GetHitIndexFromCandidates(TestingParams, CollapsedCell, 0, CachedPosition - 1, &CandidatePosition);
+			}
+		}
+		else
+		{
+			BestHit = GetHitIndexFromCandidates(TestingParams, CollapsedCell, 0, LastCandidate, &CandidatePosition);
+		}
+
+		HoverCache.bValid = false;
+		HoverCache.Path.Reset();
+		if (BestHit.IsValid() && MakeBubblePath(BestHit, DesktopSpaceCoordinate, bIgnoreEnabledStatus, UserIndex, nullptr, OutPath))
+		{
+			// A custom path depends on the cursor position, it is built again every time
+			if (!BestHit.GetWidgetData().CustomPath.IsValid())
+			{
+				HoverCache.bValid = true;
+				HoverCache.Generation = HittestGridPrivate::HittestGeneration;
+				HoverCache.CollapsedVersion = CollapsedVersion;
+				HoverCache.UserIndex = UserIndex;
+				HoverCache.bIgnoreEnabledStatus = bIgnoreEnabledStatus;
+				HoverCache.CandidatePosition = CandidatePosition;
+				HoverCache.Path.Append(OutPath);
+			}
+		}
+	}
+}
+
+bool FHittestGrid::IsHoverPathEnabled(bool bIgnoreEnabledStatus) const
+{
+	if (bIgnoreEnabledStatus)
+	{
+		return true;
+	}
+
+	// Enabled is an attribute, it can change without the grid changing. The path was cut at the first disabled widget.
+	for (const FWidgetAndPointer& Entry : HoverCache.Path)
+	{
+		if (!Entry.Widget->IsEnabled())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FHittestGrid::GetBubblePaths(TArrayView<const FVector2D> DesktopSpaceCoordinates, TArray<TArray<FWidgetAndPointer>>& OutPaths, bool bIgnoreEnabledStatus, int32 UserIndex)
+{
+	checkSlow(IsInGameThread());
+
+	OutPaths.Reset(DesktopSpaceCoordinates.Num());
+	OutPaths.SetNum(DesktopSpaceCoordinates.Num());
+
+	if (WidgetArray.Num() == 0 || Cells.Num() == 0)
+	{
+		return;
+	}
+
+	// Group the points by cell so each sorted candidate list is fetched once
+	struct FPointInCell
+	{
+		int32 PointIndex;
+		int32 CellIndex;
+		FIntPoint CellCoord;
+	};
+	TArray<FPointInCell, TInlineAllocator<16>> PointsInCell;
+	PointsInCell.Reserve(DesktopSpaceCoordinates.Num());
+	for (int32 PointIndex = 0; PointIndex < DesktopSpaceCoordinates.Num(); ++PointIndex)
+	{
+		const FIntPoint CellCoord = GetCellCoordinate(DesktopSpaceCoordinates[PointIndex] - GridOrigin);
+		PointsInCell.Add({ PointIndex, CellCoord.Y * NumCells.X + CellCoord.X, CellCoord });
+	}
+	PointsInCell.Sort([](const FPointInCell& A, const FPointInCell& B) { return A.CellIndex < B.CellIndex; });
+
+	FBubblePathCache PathCache;
+	const FCollapsedCell* CollapsedCell = nullptr;
+	int32 CollapsedCellIndex = INDEX_NONE;
+	for (const FPointInCell& PointInCell : PointsInCell)
+	{
+		if (PointInCell.CellIndex != CollapsedCellIndex)
+		{
+			CollapsedCell = &GetCollapsedWidgets(PointInCell.CellCoord.X, PointInCell.CellCoord.Y);
+			CollapsedCellIndex = PointInCell.CellIndex;
+		}
+
+		const FVector2D DesktopSpaceCoordinate = DesktopSpaceCoordinates[PointInCell.PointIndex];
+
+		FGridTestingParams TestingParams;
+		TestingParams.CursorPositionInGrid = DesktopSpaceCoordinate - GridOrigin;
+		TestingParams.CellCoord = PointInCell.CellCoord;
+		TestingParams.Radius = 0.0f;
+		TestingParams.bTestWidgetIsInteractive = false;
+
+		const FIndexAndDistance BestHit = GetHitIndexFromCandidates(TestingParams, *CollapsedCell, 0, CollapsedCell->WidgetIndexes.Num() - 1);
+		if (BestHit.IsValid())
+		{
+			MakeBubblePath(BestHit, DesktopSpaceCoordinate, bIgnoreEnabledStatus, UserIndex, &PathCache, OutPaths[PointInCell.PointIndex]);
+		}
+	}
+}
+
+void FHittestGrid::BuildAncestorChain(const FWidgetData& WidgetData, const TSharedPtr<SWidget>& FirstHitWidget, FBubblePathCache* PathCache) const
+{
+	TArray<FAncestorEntry>& AncestorChain = WidgetData.AncestorChain;
+	AncestorChain.Reset();
+
+	const FVector2D DesktopSpaceOffset = GridOrigin - GridWindowOrigin;
+	auto MakeDesktopSpaceEntry = [&DesktopSpaceOffset](const TSharedPtr<SWidget>& CurWidget)
+	{
+		FGeometry DesktopSpaceGeometry = CurWidget->GetPaintSpaceGeometry();
+		DesktopSpaceGeometry.AppendTransform(FSlateLayoutTransform(DesktopSpaceOffset));
+		return FAncestorEntry{ CurWidget, DesktopSpaceGeometry };
+	};
+
+	if (PathCache)
+	{
+		// Walk up until a widget already walked by a previous hit of the batch, then reuse its chain
+		int32 FirstNode = INDEX_NONE;
+		int32 PreviousNode = INDEX_NONE;
+		TSharedPtr<SWidget> CurWidget = FirstHitWidget;
+		while (CurWidget.IsValid())
+		{
+			int32 Node = INDEX_NONE;
+			const int32* FoundNode = PathCache->NodeMap.Find(&*CurWidget);
+			if (FoundNode)
+			{
+				Node = *FoundNode;
+			}
+			else
+			{
+				Node = PathCache->Nodes.Add({ MakeDesktopSpaceEntry(CurWidget), INDEX_NONE });
+				PathCache->NodeMap.Add(&*CurWidget, Node);
+			}
+
+			if (PreviousNode != INDEX_NONE)
+			{
+				PathCache->Nodes[PreviousNode].ParentNode = Node;
+			}
+			else
+			{
+				FirstNode = Node;
+			}
+
+			if (FoundNode)
+			{
+				break;
+			}
+			PreviousNode = Node;
+			CurWidget = CurWidget->Advanced_GetPaintParentWidget();
+		}
+
+		for (int32 Node = FirstNode; Node != INDEX_NONE; Node = PathCache->Nodes[Node].ParentNode)
+		{
+			AncestorChain.Add(PathCache->Nodes[Node].Entry);
+		}
+	}
+	else
+	{
+		TSharedPtr<SWidget> CurWidget = FirstHitWidget;
+		while (CurWidget.IsValid())
+		{
+			AncestorChain.Add(MakeDesktopSpaceEntry(CurWidget));
+			CurWidget = CurWidget->Advanced_GetPaintParentWidget();
+		}
+	}
+
+	// Stored from the window down
+	Algo::Reverse(AncestorChain);
+	WidgetData.AncestorChainOffset = DesktopSpaceOffset;
+}
+
+template<typename AllocatorType>
+bool FHittestGrid::MakeBubblePath(const FIndexAndDistance& BestHit, FVector2D DesktopSpaceCoordinate, bool bIgnoreEnabledStatus, int32 UserIndex, FBubblePathCache* PathCache, TArray<FWidgetAndPointer, AllocatorType>& OutPath) const
+{
+	const FWidgetData& BestHitWidgetData = BestHit.GetWidgetData();
+	const TSharedPtr<SWidget> FirstHitWidget = BestHitWidgetData.GetWidget();
+	// Make Sure we landed on a valid widget
+	if (!FirstHitWidget.IsValid() || !IsCompatibleUserIndex(UserIndex, BestHitWidgetData.UserIndex))
+	{
+		return false;
+	}
+
+	TArray<FWidgetAndPointer, AllocatorType>& Path = OutPath;
+	auto CopyAncestorChain = [&BestHitWidgetData, &Path]()
+	{
+		Path.Reset(BestHitWidgetData.AncestorChain.Num());
+		for (const FAncestorEntry& Entry : BestHitWidgetData.AncestorChain)
+		{
+			const TSharedPtr<SWidget> Widget = Entry.Widget.Pin();
+			if (!Widget.IsValid())
+			{
+				return false;
+			}
+			Path.Emplace(FArrangedWidget(Widget.ToSharedRef(), Entry.Geometry), TSharedPtr<FVirtualPointerPosition>());
+		}
+		return Path.Num() > 0;
+	};
+
+	// The chain is dropped every time the widget is painted again, its parents or geometry may have changed
+	const bool bChainIsValid = BestHitWidgetData.AncestorChain.Num() > 0 && BestHitWidgetData.AncestorChainOffset == GridOrigin - GridWindowOrigin;
+	if (!bChainIsValid || !CopyAncestorChain())
+	{
+		BuildAncestorChain(BestHitWidgetData, FirstHitWidget, PathCache);
+		CopyAncestorChain();
+	}
+
+	if (Path.Num() == 0 || !Path[0].Widget->Advanced_IsWindow())
+	{
+		Path.Reset();
+		return false;
+	}
+
+	bool bRemovedDisabledWidgets = false;
+	if (!bIgnoreEnabledStatus)
+	{
+		// @todo It might be more correct to remove all disabled widgets and non-hit testable widgets.  It doesn't make sense to have a hit test invisible widget as a leaf in the path
+		// and that can happen if we remove a disabled widget. Furthermore if we did this we could then append custom paths in all cases since the leaf most widget would be hit testable
+		// For backwards compatibility changing this could be risky
+		const int32 DisabledWidgetIndex = Path.IndexOfByPredicate([](const FArrangedWidget& SomeWidget) { return !SomeWidget.Widget->IsEnabled(); });
+		if (DisabledWidgetIndex != INDEX_NONE)
+		{
+			bRemovedDisabledWidgets = true;
+			Path.RemoveAt(DisabledWidgetIndex, Path.Num() - DisabledWidgetIndex);
+		}
+	}
+
+	if (!bRemovedDisabledWidgets && Path.Num() > 0)
+	{
+		if (BestHitWidgetData.CustomPath.IsValid())
+		{
+			const TArray<FWidgetAndPointer> BubblePathExtension = BestHitWidgetData.CustomPath.Pin()->GetBubblePathAndVirtualCursors(FirstHitWidget->GetTickSpaceGeometry(), DesktopSpaceCoordinate, bIgnoreEnabledStatus);
+			Path.Append(BubblePathExtension);
+		}
+	}
+
+	return Path.Num() > 0;
+}
+
+bool FHittestGrid::SetHittestArea(const FVector2D& HittestPositionInDesktop, const FVector2D& HittestDimensions, const FVector2D& HitestOffsetInWindow)
+{
+	bool bWasCleared = false;
+
+	const FVector2D DesiredCellSize(FMath::Max(GSlateHitTestGridCellSize, 16));
+
+	// If the size of the hit test area changes we need to clear it out
+	if (GridSize != HittestDimensions || CellSize != DesiredCellSize)
+	{
+		GridSize = HittestDimensions;
+		CellSize = DesiredCellSize;
+		NumCells = FIntPoint(FMath::CeilToInt(GridSize.X / CellSize.X), FMath::CeilToInt(GridSize.Y / CellSize.Y));
+		
+		const int32 NewTotalCells = NumCells.X * NumCells.Y;
+		ClearInternal(NewTotalCells);
+		HittestGridPrivate::MarkAppendedGridsChanged();
+
+		bWasCleared = true;
+	}
+
+	if (GridOrigin != HittestPositionInDesktop || GridWindowOrigin != HitestOffsetInWindow)
+	{
+		HittestGridPrivate::MarkHittestChanged();
+		HittestGridPrivate::MarkAppendedGridsChanged();
+	}
+	GridOrigin = HittestPositionInDesktop;
+	GridWindowOrigin = HitestOffsetInWindow;
+
+	return bWasCleared;
+}
+
+void FHittestGrid::Clear()
+{
+	const int32 TotalCells = Cells.Num();
+	ClearInternal(TotalCells);
+}
+
+void FHittestGrid::ClearInternal(int32 TotalCells)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SlateHTG_Clear);
+	HittestGridPrivate::MarkHittestChanged();
+	Cells.Reset(TotalCells);
+	Cells.SetNum(TotalCells);
+	CollapsedCells.Reset(TotalCells);
+	CollapsedCells.SetNum(TotalCells);
+	RootCell = FCell();
+	bNavigationEdgesDirty = true;
+	// Don't keep the widgets of the cached path alive
+	HoverCache = FHoverCache();
+
+	WidgetMap.Reset();
+	WidgetArray.Reset();
+    // HankShu-inkiu0@gmail.com add ClickClip Start
+	ClickClipBlocks.Reset();
+    // HankShu-inkiu0@gmail.com add ClickClip End
+	AppendedGridArray.Reset();
+	HittestGridPrivate::MarkAppendedGridsChanged();
+}
+
+bool FHittestGrid::IsDescendantOf(const TSharedRef<SWidget> Parent, const FWidgetData& ChildData) const
+{
+	const TSharedPtr<SWidget> ChildWidgetPtr = ChildData.GetWidget();
+	if (ChildWidgetPtr == Parent)
+	{
+		return false;
+	}
+
+	const SWidget* ParentWidget = &Parent.Get();
+	const SWidget* CurWidget = ChildWidgetPtr.Get();
+
+	while (CurWidget)
+	{
+		if (ParentWidget == CurWidget)
+		{
+			return true;
+		}
+		CurWidget = CurWidget->Advanced_GetPaintParentWidget().Get();
+	}
+
+	return false;
+}
+
+#if WITH_SLATE_DEBUGGING
+namespace HittestGridDebuggingText
+{
+	static FText Valid = LOCTEXT("StateValid", "Valid"); //~ The widget is valid will be consider as the result
+	static FText NotCompatibleWithUserIndex = LOCTEXT("StateNotCompatibleWithUserIndex", "User Index not compatible"); //~ The widget is not compatible with the requested user index
+	static FText DoesNotIntersect = LOCTEXT("StateDoesNotIntersect", "Does not intersect"); //~ The widget rect is not in the correct direction or is not intersecting with the "swept" rectangle
+	static FText PreviousWidgetIsBetter = LOCTEXT("StatePreviousWidgetIsBetter", "Previous Widget was better"); //~ The widget would be valid but the previous valid is closer
+	static FText NotADescendant = LOCTEXT("StateNotADescendant", "Not a descendant"); //~ We have a non escape boundary condition and the widget isn't a descendant of our boundary
+	static FText Disabled = LOCTEXT("StateNotEnabled", "Disabled"); //~ The widget is not enabled
+	static FText DoesNotSuportKeyboardFocus = LOCTEXT("StateDoesNotSuportKeyboardFocus", "Keyboard focus unsupported"); //~ THe widget does not support keyboard focus
+}
+	#define AddToNextFocusableWidgetCondidateDebugResults(Candidate, Result) { if (IntermediateResultsPtr) { IntermediateResultsPtr->Emplace((Candidate), (Result)); } }
+#else
+	#define AddToNextFocusableWidgetCondidateDebugResults(Candidate, Result) CA_ASSUME(Candidate)
+#endif
+
+void FHittestGrid::UpdateNavigationEdges() const
+{
+	if (!bNavigationEdgesDirty)
+	{
+		return;
+	}
+
+	for (TArray<FNavigationEdge>& Edges : NavigationEdges)
+	{
+		Edges.Reset();
+	}
+
+	for (TSparseArray<FWidgetData>::TConstIterator It(WidgetArray); It; ++It)
+	{
+		if (It->bSupportsKeyboardFocus)
+		{
+			const FSlateRect& Rect = It->BoundingRect;
+			NavigationEdges[0].Add({ Rect.Left, It.GetIndex() });
+			NavigationEdges[1].Add({ Rect.Top, It.GetIndex() });
+			NavigationEdges[2].Add({ Rect.Right, It.GetIndex() });
+			NavigationEdges[3].Add({ Rect.Bottom, It.GetIndex() });
+		}
+	}
+
+	// Sorted in the order a navigation in that direction reaches them
+	NavigationEdges[0].Sort([](const FNavigationEdge& A, const FNavigationEdge& B) { return A.Edge < B.Edge; });
+	NavigationEdges[1].Sort([](const FNavigationEdge& A, const FNavigationEdge& B) { return A.Edge < B.Edge; });
+	NavigationEdges[2].Sort([](const FNavigationEdge& A, const FNavigationEdge& B) { return A.Edge > B.Edge; });
+	NavigationEdges[3].Sort([](const FNavigationEdge& A, const FNavigationEdge& B) { return A.Edge > B.Edge; });
+
+	bNavigationEdgesDirty = false;
+}
+
+template<typename TCompareFunc, typename TSourceSideFunc, typename TDestSideFunc>
+TSharedPtr<SWidget> FHittestGrid::FindFocusableWidget(FSlateRect WidgetRect, const FSlateRect SweptRect, int32 AxisIndex, int32 Increment, const EUINavigation Direction, const FNavigationReply& NavigationReply, TCompareFunc CompareFunc, TSourceSideFunc SourceSideFunc, TDestSideFunc DestSideFunc, int32 UserIndex, TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult>* IntermediateResultsPtr) const
+{
+	float CurrentSourceSide = SourceSideFunc(WidgetRect);
+
+	// Ensure that the hit test grid is valid before proceeding
+	if (NumCells.X < 1 || NumCells.Y < 1)
+	{
+		return TSharedPtr<SWidget>();
+	}
+
+	const FCollapsedHittestGridArray& AllHitTestGrids = GetCollapsedHittestGrid();
+
+	// Left, Top, Right or Bottom edges, sorted in the navigation direction
+	const int32 EdgeListIndex = AxisIndex + (Increment > 0 ? 0 : 2);
+
+	bool bWrapped = false;
+	while (true)
+	{
+		FSlateRect BestWidgetRect;
+		TSharedPtr<SWidget> BestWidget = TSharedPtr<SWidget>();
+
+		for (const FHittestGrid* HittestGrid : AllHitTestGrids)
+		{
+			HittestGrid->UpdateNavigationEdges();
+			const TArray<FNavigationEdge>& Edges = HittestGrid->NavigationEdges[EdgeListIndex];
+
+			// Binary search the first edge past the source side
+			int32 FirstEdgeIndex = 0;
+			for (int32 Count = Edges.Num(); Count > 0;)
+			{
+				const int32 Step = Count / 2;
+				if (!CompareFunc(Edges[FirstEdgeIndex + Step].Edge, CurrentSourceSide))
+				{
+					FirstEdgeIndex += Step + 1;
+					Count -= Step + 1;
+				}
+				else
+				{
+					Count = Step;
+				}
+			}
+
+			// The first valid widget is the closest one of this grid
+			for (int32 EdgeIndex = FirstEdgeIndex; EdgeIndex < Edges.Num(); ++EdgeIndex)
+			{
+				// Edges only get further, nothing left can beat the best widget of a previous grid
+				if (BestWidget.IsValid() && !CompareFunc(DestSideFunc(BestWidgetRect), Edges[EdgeIndex].Edge))
+				{
+					AddToNextFocusableWidgetCondidateDebugResults(HittestGrid->WidgetArray[Edges[EdgeIndex].WidgetIndex].GetWidget(), HittestGridDebuggingText::PreviousWidgetIsBetter);
+					break;
+				}
+
+				const FWidgetData& TestCandidate = HittestGrid->WidgetArray[Edges[EdgeIndex].WidgetIndex];
+				const FSlateRect& TestCandidateRect = TestCandidate.BoundingRect;
+				if (!FSlateRect::DoRectanglesIntersect(SweptRect, TestCandidateRect))
+				{
+					AddToNextFocusableWidgetCondidateDebugResults(TestCandidate.GetWidget(), HittestGridDebuggingText::DoesNotIntersect);
+					continue;
+				}
+
+				const TSharedPtr<SWidget> TestWidget = TestCandidate.GetWidget();
+				if (!TestWidget.IsValid())
+				{
+					continue;
+				}
+
+				if (!IsCompatibleUserIndex(UserIndex, TestCandidate.UserIndex))
+				{
+					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::NotCompatibleWithUserIndex);
+					continue;
+				}
+
+				// If we have a non escape boundary condition and this widget isn't a descendant of our boundary condition widget then it's invalid so we keep looking.
+				if (NavigationReply.GetBoundaryRule() != EUINavigationRule::Escape
+					&& NavigationReply.GetHandler().IsValid()
+					&& !IsDescendantOf(NavigationReply.GetHandler().ToSharedRef(), TestCandidate))
+				{
+					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::NotADescendant);
+					continue;
+				}
+
+				if (!TestWidget->IsEnabled())
+				{
+					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::Disabled);
+					continue;
+				}
+				
+				if (!TestWidget->SupportsKeyboardFocus())
+				{
+					AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::DoesNotSuportKeyboardFocus);
+					continue;
+				}
+
+				BestWidgetRect = TestCandidateRect;
+				BestWidget = TestWidget;
+				AddToNextFocusableWidgetCondidateDebugResults(TestWidget, HittestGridDebuggingText::Valid);
+				break;
+			}
+		}
+
+		if (BestWidget.IsValid())
+		{
+			// Check for the need to apply our rule
+			if (CompareFunc(DestSideFunc(BestWidgetRect), SourceSideFunc(SweptRect)))
+			{
+				switch (NavigationReply.GetBoundaryRule())
+				{
+				case EUINavigationRule::Explicit:
+					return NavigationReply.GetFocusRecipient();
+				case EUINavigationRule::Custom:
+				case EUINavigationRule::CustomBoundary:
+				{
+					const FNavigationDelegate& FocusDelegate = NavigationReply.GetFocusDelegate();
+					if (FocusDelegate.IsBound())
+					{
+						return FocusDelegate.Execute(Direction);
+					}
+					return TSharedPtr<SWidget>();
+				}
+				case EUINavigationRule::Stop:
+					return TSharedPtr<SWidget>();
+				case EUINavigationRule::Wrap:
+					break;
+				}
+			}
+
+			return BestWidget;
+		}
+
+		// Nothing ahead, handle the boundary condition (Wrap or CustomBoundary) appropriately
+		if (NavigationReply.GetBoundaryRule() == EUINavigationRule::Wrap)
+		{
+			if (bWrapped)
+			{
+				// If we've already wrapped, unfortunately it must be that the starting widget wasn't within the boundary
+				break;
+			}
+			CurrentSourceSide = DestSideFunc(SweptRect);
+			bWrapped = true;
+		}
+		else
+		{
+			if (NavigationReply.GetBoundaryRule() == EUINavigationRule::CustomBoundary)
+			{
+				const FNavigationDelegate& FocusDelegate = NavigationReply.GetFocusDelegate();
+				if (FocusDelegate.IsBound())
+				{
+					return FocusDelegate.Execute(Direction);
+				}
+			}
+			break;
+		}
+	}
+
+	return TSharedPtr<SWidget>();
+}
+
+#undef AddToNextFocusableWidgetCondidateDebugResults
+
+TSharedPtr<SWidget> FHittestGrid::FindNextFocusableWidget(const FArrangedWidget& StartingWidget, const EUINavigation Direction, const FNavigationReply& NavigationReply, const FArrangedWidget& RuleWidget, int32 UserIndex)
+{
+	FGeometry StartingWidgetGeo = StartingWidget.Widget->GetPaintSpaceGeometry();
+	StartingWidgetGeo.AppendTransform(FSlateLayoutTransform(-GridWindowOrigin));
+	FSlateRect WidgetRect = StartingWidgetGeo.GetRenderBoundingRect();
+
+	FGeometry BoundingRuleWidgetGeo = RuleWidget.Widget->GetPaintSpaceGeometry();
+	BoundingRuleWidgetGeo.AppendTransform(FSlateLayoutTransform(-GridWindowOrigin));
+	FSlateRect BoundingRuleRect = BoundingRuleWidgetGeo.GetRenderBoundingRect();
+
+	FSlateRect SweptWidgetRect = WidgetRect;
+
+	TSharedPtr<SWidget> Widget = TSharedPtr<SWidget>();
+
+#if WITH_SLATE_DEBUGGING
+	TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult> IntermediateResults;
+	TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult>* IntermediateResultsPtr = OnFindNextFocusableWidgetExecuted.IsBound() ? &IntermediateResults : nullptr;
+#else
+	TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult>* IntermediateResultsPtr = nullptr;
+#endif
+
+	switch (Direction)
+	{
+	case EUINavigation::Left:
+		SweptWidgetRect.Left = BoundingRuleRect.Left;
+		SweptWidgetRect.Right = BoundingRuleRect.Right;
+		SweptWidgetRect.Top += 0.5f;
+		SweptWidgetRect.Bottom -= 0.5f;
+		Widget = FindFocusableWidget(WidgetRect, SweptWidgetRect, 0, -1, Direction, NavigationReply,
+			[](float A, float B) { return A - 0.1f < B; }, // Compare function
+			[](FSlateRect SourceRect) { return SourceRect.Left; }, // Source side function
+			[](FSlateRect DestRect) { return DestRect.Right; }, // Dest side function
+			UserIndex, IntermediateResultsPtr);
+		break;
+	case EUINavigation::Right:
+		SweptWidgetRect.Left = BoundingRuleRect.Left;
+		SweptWidgetRect.Right = BoundingRuleRect.Right;
+		SweptWidgetRect.Top += 0.5f;
+		SweptWidgetRect.Bottom -= 0.5f;
+		Widget = FindFocusableWidget(WidgetRect, SweptWidgetRect, 0, 1, Direction, NavigationReply,
+			[](float A, float B) { return A + 0.1f > B; }, // Compare function
+			[](FSlateRect SourceRect) { return SourceRect.Right; }, // Source side function
+			[](FSlateRect DestRect) { return DestRect.Left; }, // Dest side function
+			UserIndex, IntermediateResultsPtr);
+		break;
+	case EUINavigation::Up:
+		SweptWidgetRect.Top = BoundingRuleRect.Top;
+		SweptWidgetRect.Bottom = BoundingRuleRect.Bottom;
+		SweptWidgetRect.Left += 0.5f;
+		SweptWidgetRect.Right -= 0.5f;
+		Widget = FindFocusableWidget(WidgetRect, SweptWidgetRect, 1, -1, Direction, NavigationReply,
+			[](float A, float B) { return A - 0.1f < B; }, // Compare function
+			[](FSlateRect SourceRect) { return SourceRect.Top; }, // Source side function
+			[](FSlateRect DestRect) { return DestRect.Bottom; }, // Dest side function
+			UserIndex, IntermediateResultsPtr);
+		break;
+	case EUINavigation::Down:
+		SweptWidgetRect.Top = BoundingRuleRect.Top;
+		SweptWidgetRect.Bottom = BoundingRuleRect.Bottom;
+		SweptWidgetRect.Left += 0.5f;
+		SweptWidgetRect.Right -= 0.5f;
+		Widget = FindFocusableWidget(WidgetRect, SweptWidgetRect, 1, 1, Direction, NavigationReply,
+			[](float A, float B) { return A + 0.1f > B; }, // Compare function
+			[](FSlateRect SourceRect) { return SourceRect.Bottom; }, // Source side function
+			[](FSlateRect DestRect) { return DestRect.Top; }, // Dest side function
+			UserIndex, IntermediateResultsPtr);
+		break;
+
+	default:
+		break;
+	}
+
+#if WITH_SLATE_DEBUGGING
+	if (IntermediateResultsPtr)
+	{
+		FDebuggingFindNextFocusableWidgetArgs Args {StartingWidget, Direction, NavigationReply, RuleWidget, UserIndex, Widget , MoveTemp(*IntermediateResultsPtr)};
+		OnFindNextFocusableWidgetExecuted.Broadcast(this, Args);
+	}
+#endif
+
+	return Widget;
+}
+
+FIntPoint FHittestGrid::GetCellCoordinate(FVector2D Position) const
+{
+	return FIntPoint(
+		FMath::Min(FMath::Max(FMath::FloorToInt(Position.X / CellSize.X), 0), NumCells.X - 1),
+		FMath::Min(FMath::Max(FMath::FloorToInt(Position.Y / CellSize.Y), 0), NumCells.Y - 1));
+}
+
+bool FHittestGrid::IsRootCellSpan(const FIntPoint& UpperLeftCell, const FIntPoint& LowerRightCell) const
+{
+	const int32 CoveredCells = (LowerRightCell.X - UpperLeftCell.X + 1) * (LowerRightCell.Y - UpperLeftCell.Y + 1);
+	return GSlateHitTestGridRootCellThreshold > 0 && CoveredCells >= GSlateHitTestGridRootCellThreshold;
+}
+
+bool FHittestGrid::IsValidCellCoord(const FIntPoint& CellCoord) const
+{
+	return IsValidCellCoord(CellCoord.X, CellCoord.Y);
+}
+
+bool FHittestGrid::IsValidCellCoord(const int32 XCoord, const int32 YCoord) const
+{
+	return XCoord >= 0 && XCoord < NumCells.X && YCoord >= 0 && YCoord < NumCells.Y;
+}
+
+void FHittestGrid::AddGrid(const TSharedRef<const FHittestGrid>& OtherGrid)
+{
+	auto GetCollapsedHittestGrid_NoTests = [](const FHittestGrid* HittestGrid, FCollapsedHittestGridArray& OutResult)
+	{
+		OutResult.Add(HittestGrid);
+		for (int32 Index = 0; Index < OutResult.Num(); ++Index)
+		{
+			for (const FAppendedGridData& AppendedGridData : OutResult[Index]->AppendedGridArray)
+			{
+				if (const TSharedPtr<const FHittestGrid> Grid = AppendedGridData.Grid.Pin())
+				{
+					OutResult.Add(Grid.Get());
+				}
+			}
+		}
+	};
+
+	const bool bIsContains = AppendedGridArray.ContainsByPredicate([OtherGrid](const FAppendedGridData& Other) { return Other.Grid == OtherGrid; });
+	if (ensure(CanBeAppended(&OtherGrid.Get())))
+	{
+		if (!bIsContains)
+		{
+			// Check for recursion
+			FCollapsedHittestGridArray AllHittestGrid;
+			GetCollapsedHittestGrid_NoTests(this, AllHittestGrid); // we are building a new array, do not perform size check
+			const bool bIsInCollapsed = AllHittestGrid.ContainsByPredicate([OtherGrid](const FHittestGrid* Other) { return &*OtherGrid == Other; });
+			ensure(!bIsInCollapsed);
+			if (bIsInCollapsed)
+			{
+				return;
+			}
+
+			AppendedGridArray.Emplace(OtherGrid->Owner, OtherGrid);
+			HittestGridPrivate::MarkHittestChanged();
+			HittestGridPrivate::MarkAppendedGridsChanged();
+		}
+	}
+	else
+	{
+		RemoveGrid(OtherGrid);
+	}
+}
+
+void FHittestGrid::RemoveGrid(const TSharedRef<const FHittestGrid>& OtherGrid)
+{
+	const int32 AppendedGridIndex = AppendedGridArray.IndexOfByPredicate(
+		[OtherGrid](const FAppendedGridData& Other)
+		{
+			return Other.Grid == OtherGrid;
+		});
+	if (AppendedGridIndex != INDEX_NONE)
+	{
+		AppendedGridArray.RemoveAtSwap(AppendedGridIndex);
+		HittestGridPrivate::MarkHittestChanged();
+		HittestGridPrivate::MarkAppendedGridsChanged();
+	}
+}
+
+void FHittestGrid::RemoveGrid(const SWidget* OtherGridOwner)
+{
+	const int32 AppendedGridIndex = AppendedGridArray.IndexOfByPredicate(
+		[OtherGridOwner](const FAppendedGridData& Other)
+		{
+			return Other.CachedOwner == OtherGridOwner;
+		});
+	if (AppendedGridIndex != INDEX_NONE)
+	{
+#if WITH_SLATE_DEBUGGING
+		// Confirmed that the cached grid is valid
+		if (const TSharedPtr<const FHittestGrid> Pin = AppendedGridArray[AppendedGridIndex].Grid.Pin())
+		{
+			ensure(Pin->Owner == OtherGridOwner);
+		}
+#endif
+		AppendedGridArray.RemoveAtSwap(AppendedGridIndex);
+		HittestGridPrivate::MarkHittestChanged();
+		HittestGridPrivate::MarkAppendedGridsChanged();
+	}
+}
+
+bool FHittestGrid::CanBeAppended(const FHittestGrid* OtherGrid) const
+{
+	return OtherGrid && OtherGrid->Owner && this != OtherGrid && SameSize(OtherGrid);
+}
+
+bool FHittestGrid::SameSize(const FHittestGrid* OtherGrid) const
+{
+	return GridOrigin == OtherGrid->GridOrigin && GridWindowOrigin == OtherGrid->GridWindowOrigin && GridSize == OtherGrid->GridSize && CellSize == OtherGrid->CellSize;
+}
+
+void FHittestGrid::AddWidget(const TSharedRef<SWidget>& InWidget, int32 InBatchPriorityGroup, int32 InLayerId, int32 InSecondarySort)
+{
+	if (!InWidget->GetVisibility().IsHitTestVisible())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_SlateHTG_AddWidget);
+
+	// Track the widget and identify it's Widget Index
+	FGeometry GridSpaceGeometry = InWidget->GetPaintSpaceGeometry();
+	GridSpaceGeometry.AppendTransform(FSlateLayoutTransform(-GridWindowOrigin));
+
+	// Currently using grid offset because the grid covers all desktop space.
+	const FSlateRect BoundingRect = GridSpaceGeometry.GetRenderBoundingRect();
+
+	// Starting and ending cells covered by this widget.	
+	const FIntPoint UpperLeftCell = GetCellCoordinate(BoundingRect.GetTopLeft());
+	const FIntPoint LowerRightCell = GetCellCoordinate(BoundingRect.GetBottomRight());
+
+	const bool bInRootCell = IsRootCellSpan(UpperLeftCell, LowerRightCell);
+	const bool bSupportsKeyboardFocus = InWidget->SupportsKeyboardFocus();
+
+	const int64 PrimarySort = (((int64)InBatchPriorityGroup << 32) | InLayerId);
+
+	if (int32* FoundIndex = WidgetMap.Find(&*InWidget))
+	{
+		// Update in place, the widget keeps its index
+		const int32 WidgetIndex = *FoundIndex;
+		FWidgetData& WidgetData = WidgetArray[WidgetIndex];
+		// Painted again, its paint parents may have changed
+		WidgetData.AncestorChain.Reset();
+		if ((WidgetData.bSupportsKeyboardFocus || bSupportsKeyboardFocus)
+			&& (WidgetData.bSupportsKeyboardFocus != bSupportsKeyboardFocus || WidgetData.BoundingRect != BoundingRect))
+		{
+			bNavigationEdgesDirty = true;
+		}
+		WidgetData.bSupportsKeyboardFocus = bSupportsKeyboardFocus;
+		if (WidgetData.BoundingRect != BoundingRect || WidgetData.UserIndex != CurrentUserIndex)
+		{
+			HittestGridPrivate::MarkHittestChanged();
+			WidgetData.BoundingRect = BoundingRect;
+		}
+		UpdateWidgetCells(WidgetIndex, WidgetData, bInRootCell, UpperLeftCell, LowerRightCell);
+		if (WidgetData.PrimarySort != PrimarySort || WidgetData.SecondarySort != InSecondarySort)
+		{
+			HittestGridPrivate::MarkHittestChanged();
+			MarkCellsSortDirty(WidgetData);
+		}
+		WidgetData.PrimarySort = PrimarySort;
+		WidgetData.SecondarySort = InSecondarySort;
+		WidgetData.UserIndex = CurrentUserIndex;
+	}
+	else
+	{
+		const int32 WidgetIndex = WidgetArray.Emplace(InWidget, UpperLeftCell, LowerRightCell, PrimarySort, InSecondarySort, CurrentUserIndex);
+		WidgetMap.Add(&*InWidget, WidgetIndex);
+		FWidgetData& WidgetData = WidgetArray[WidgetIndex];
+		WidgetData.BoundingRect = BoundingRect;
+		WidgetData.bInRootCell = bInRootCell;
+		WidgetData.bSupportsKeyboardFocus = bSupportsKeyboardFocus;
+		bNavigationEdgesDirty |= bSupportsKeyboardFocus;
+		HittestGridPrivate::MarkHittestChanged();
+		AddWidgetToCells(WidgetIndex, WidgetData);
+	}
+}
+
+void FHittestGrid::AddWidgetToCells(int32 WidgetIndex, const FWidgetData& WidgetData)
+{
+	if (WidgetData.bInRootCell)
+	{
+		RootCell.AddIndex(WidgetIndex);
+		return;
+	}
+
+	for (int32 XIndex = WidgetData.UpperLeftCell.X; XIndex <= WidgetData.LowerRightCell.X; ++XIndex)
+	{
+		for (int32 YIndex = WidgetData.UpperLeftCell.Y; YIndex <= WidgetData.LowerRightCell.Y; ++YIndex)
+		{
+			if (IsValidCellCoord(XIndex, YIndex))
+			{
+				CellAt(XIndex, YIndex).AddIndex(WidgetIndex);
+			}
+		}
+	}
+}
+
+void FHittestGrid::RemoveWidgetFromCells(int32 WidgetIndex, const FWidgetData& WidgetData)
+{
+	if (WidgetData.bInRootCell)
+	{
+		RootCell.RemoveIndex(WidgetIndex);
+		return;
+	}
+
+	for (int32 XIndex = WidgetData.UpperLeftCell.X; XIndex <= WidgetData.LowerRightCell.X; ++XIndex)
+	{
+		for (int32 YIndex = WidgetData.UpperLeftCell.Y; YIndex <= WidgetData.LowerRightCell.Y; ++YIndex)
+		{
+			checkSlow(IsValidCellCoord(XIndex, YIndex));
+			CellAt(XIndex, YIndex).RemoveIndex(WidgetIndex);
+		}
+	}
+}
+
+void FHittestGrid::UpdateWidgetCells(int32 WidgetIndex, FWidgetData& WidgetData, bool bInRootCell, const FIntPoint& UpperLeftCell, const FIntPoint& LowerRightCell)
+{
+	const FIntPoint OldUpperLeftCell = WidgetData.UpperLeftCell;
+	const FIntPoint OldLowerRightCell = WidgetData.LowerRightCell;
+	const bool bWasInRootCell = WidgetData.bInRootCell;
+
+	if (bWasInRootCell != bInRootCell)
+	{
+		RemoveWidgetFromCells(WidgetIndex, WidgetData);
+		WidgetData.UpperLeftCell = UpperLeftCell;
+		WidgetData.LowerRightCell = LowerRightCell;
+		WidgetData.bInRootCell = bInRootCell;
+		AddWidgetToCells(WidgetIndex, WidgetData);
+		return;
+	}
+
+	// A RootCell widget moving doesn't touch any cell
+	WidgetData.UpperLeftCell = UpperLeftCell;
+	WidgetData.LowerRightCell = LowerRightCell;
+	if (bInRootCell || (OldUpperLeftCell == UpperLeftCell && OldLowerRightCell == LowerRightCell))
+	{
+		return;
+	}
+
+	auto IsInRange = [](int32 XIndex, int32 YIndex, const FIntPoint& RangeUpperLeft, const FIntPoint& RangeLowerRight)
+	{
+		return XIndex >= RangeUpperLeft.X && XIndex <= RangeLowerRight.X && YIndex >= RangeUpperLeft.Y && YIndex <= RangeLowerRight.Y;
+	};
+
+	// Only the cells the widget left or entered are touched
+	for (int32 XIndex = OldUpperLeftCell.X; XIndex <= OldLowerRightCell.X; ++XIndex)
+	{
+		for (int32 YIndex = OldUpperLeftCell.Y; YIndex <= OldLowerRightCell.Y; ++YIndex)
+		{
+			if (!IsInRange(XIndex, YIndex, UpperLeftCell, LowerRightCell))
+			{
+				checkSlow(IsValidCellCoord(XIndex, YIndex));
+				CellAt(XIndex, YIndex).RemoveIndex(WidgetIndex);
+			}
+		}
+	}
+
+	for (int32 XIndex = UpperLeftCell.X; XIndex <= LowerRightCell.X; ++XIndex)
+	{
+		for (int32 YIndex = UpperLeftCell.Y; YIndex <= LowerRightCell.Y; ++YIndex)
+		{
+			if (!IsInRange(XIndex, YIndex, OldUpperLeftCell, OldLowerRightCell) && IsValidCellCoord(XIndex, YIndex))
+			{
+				CellAt(XIndex, YIndex).AddIndex(WidgetIndex);
+			}
+		}
+	}
+}
+
+void FHittestGrid::RemoveWidget(const TSharedRef<SWidget>& InWidget)
+{
+	RemoveWidget(&*InWidget);
+}
+
+void FHittestGrid::RemoveWidget(const SWidget* InWidget)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SlateHTG_RemoveWidget);
+
+	int32 WidgetIndex = INDEX_NONE;
+	if (WidgetMap.RemoveAndCopyValue(InWidget, WidgetIndex))
+	{
+		FWidgetData& WidgetData = WidgetArray[WidgetIndex];
+		// HankShu-inkiu0@gmail.com add ClickClip Start
+		ReleaseClickClipBlock(WidgetData.ClickClipBlockIndex);
+		// HankShu-inkiu0@gmail.com add ClickClip end
+
+		RemoveWidgetFromCells(WidgetIndex, WidgetData);
+		bNavigationEdgesDirty |= WidgetData.bSupportsKeyboardFocus;
+
+		WidgetArray.RemoveAt(WidgetIndex);
+		HittestGridPrivate::MarkHittestChanged();
+		// The cached path may hold the widget
+		HoverCache = FHoverCache();
+	}
+
+	RemoveGrid(InWidget);
+}
+
+void FHittestGrid::InsertCustomHitTestPath(const TSharedRef<SWidget> InWidget, TSharedRef<ICustomHitTestPath> CustomHitTestPath)
+{
+	int32 WidgetIndex = WidgetMap.FindChecked(&*InWidget);
+	FWidgetData& WidgetData = WidgetArray[WidgetIndex];
+	if (WidgetData.CustomPath != CustomHitTestPath)
+	{
+		HittestGridPrivate::MarkHittestChanged();
+	}
+	WidgetData.CustomPath = CustomHitTestPath;
+}
+
+FHittestGrid::FIndexAndDistance FHittestGrid::GetHitIndexFromCellIndex(const FGridTestingParams& Params) const
+{
+	//check if the cell coord 
+	if (IsValidCellCoord(Params.CellCoord))
+	{
+		// Get the sorted cell
+		const FCollapsedCell& CollapsedCell = GetCollapsedWidgets(Params.CellCoord.X, Params.CellCoord.Y);
+		return GetHitIndexFromCandidates(Params, CollapsedCell, 0, CollapsedCell.WidgetIndexes.Num() - 1);
+	}
+
+	return FIndexAndDistance();
+}
+
+FHittestGrid::FIndexAndDistance FHittestGrid::GetHitIndexFromCandidates(const FGridTestingParams& Params, const FCollapsedCell& CollapsedCell, int32 FirstCandidate, int32 LastCandidate, int32* OutCandidatePosition) const
+{
+	const FCollapsedWidgetsArray& WidgetIndexes = CollapsedCell.WidgetIndexes;
+
+#if 0 //Unroll some data for debugging if necessary
+	struct FDebugData
+	{
+		FWidgetData WidgetData;
+		FName WidgetType;
+		FName WidgetLoc;
+		TSharedPtr<SWidget> Widget;
+	};
+
+	TArray<FDebugData> DebugData;
+	for (int32 i = 0; i < WidgetIndexes.Num(); ++i)
+	{
+		FDebugData& Cur = DebugData.AddDefaulted_GetRef();
+		Cur.WidgetData = WidgetIndexes[i].GetWidgetData();
+		Cur.Widget = Cur.WidgetData.GetWidget();
+		Cur.WidgetType = Cur.Widget.IsValid() ? Cur.Widget->GetType() : NAME_None;
+		Cur.WidgetLoc = Cur.Widget.IsValid() ? Cur.Widget->GetCreatedInLocation() : NAME_None;
+	}
+#endif
+
+	LastCandidate = FMath::Min(LastCandidate, WidgetIndexes.Num() - 1);
+	if (LastCandidate < FirstCandidate)
+	{
+		return FIndexAndDistance();
+	}
+
+	// The cursor and its radius, grown by a pixel so the bounds rejection never disagrees with the exact test on an edge
+	const float Reach = FMath::Max(Params.Radius, 0.0f) + 1.0f;
+	const VectorRegister CursorMinX = VectorSetFloat1(Params.CursorPositionInGrid.X - Reach);
+	const VectorRegister CursorMinY = VectorSetFloat1(Params.CursorPositionInGrid.Y - Reach);
+	const VectorRegister CursorMaxX = VectorSetFloat1(Params.CursorPositionInGrid.X + Reach);
+	const VectorRegister CursorMaxY = VectorSetFloat1(Params.CursorPositionInGrid.Y + Reach);
+
+	// Consider front-most widgets first for hittesting.
+	int32 OverlappingMask = 0;
+	for (int32 i = LastCandidate; i >= FirstCandidate; --i)
+	{
+		const int32 Lane = i & 3;
+		if (Lane == 3 || i == LastCandidate)
+		{
+			// Reject the whole group of 4 candidates from their bounds before pinning any of them
+			const int32 GroupStart = i & ~3;
+			const VectorRegister Overlapping = VectorBitwiseAnd(
+				VectorBitwiseAnd(
+					VectorCompareGE(CursorMaxX, VectorLoadAligned(&CollapsedCell.Bounds[0][GroupStart])),
+					VectorCompareGE(VectorLoadAligned(&CollapsedCell.Bounds[2][GroupStart]), CursorMinX)),
+				VectorBitwiseAnd(
+					VectorCompareGE(CursorMaxY, VectorLoadAligned(&CollapsedCell.Bounds[1][GroupStart])),
+					VectorCompareGE(VectorLoadAligned(&CollapsedCell.Bounds[3][GroupStart]), CursorMinY)));
+			OverlappingMask = VectorMaskBits(Overlapping);
+			if (OverlappingMask == 0)
+			{
+				i = GroupStart;
+				continue;
+			}
+		}
+
+		if ((OverlappingMask & (1 << Lane)) == 0)
+		{
+			continue;
+		}
+
+		check(WidgetIndexes[i].IsValid());
+		const FWidgetData& TestCandidate = WidgetIndexes[i].GetWidgetData();
+		const TSharedPtr<SWidget> TestWidget = TestCandidate.GetWidget();
+
+		// When performing a point hittest, accept all hittestable widgets.
+		// When performing a hittest with a radius, only grab interactive widgets.
+		const bool bIsValidWidget = TestWidget.IsValid() && (!Params.bTestWidgetIsInteractive || TestWidget->IsInteractable());
+		if (bIsValidWidget)
+		{
+			const FVector2D WindowSpaceCoordinate = Params.CursorPositionInGrid + GridWindowOrigin;
+
+			const FGeometry& TestGeometry = TestWidget->GetPaintSpaceGeometry();
+
+			bool bPointInsideClipMasks = true;
+
+			if (WidgetIndexes[i].GetCullingRect().IsValid())
+			{
+				bPointInsideClipMasks = WidgetIndexes[i].GetCullingRect().ContainsPoint(WindowSpaceCoordinate);
+			}
+
+			if (bPointInsideClipMasks)
+			{
+				const TOptional<FSlateClippingState>& WidgetClippingState = TestWidget->GetCurrentClippingState();
+				if (WidgetClippingState.IsSet())
+				{
+					// TODO: Solve non-zero radius cursors?
+					bPointInsideClipMasks = WidgetClippingState->IsPointInside(WindowSpaceCoordinate);
+				}
+			}
+
+			// HankShu-inkiu0@gmail.com add ClickClip Start
+			// The candidate may come from an appended grid, its ClickClips live there
+			const bool IsClickThrough = bPointInsideClipMasks
+				&& TestCandidate.ClickClipBlockIndex != INDEX_NONE
+				&& WidgetIndexes[i].GetGrid()->IsThroughClickClip(WindowSpaceCoordinate, TestCandidate);
+			if (bPointInsideClipMasks && !IsClickThrough)
+			// HankShu-inkiu0@gmail.com add ClickClip End
+			{
+				// Compute the render space clipping rect (FGeometry exposes a layout space clipping rect).
+				const FSlateRotatedRect WindowOrientedClipRect = TransformRect(
+					Concatenate(
+						Inverse(TestGeometry.GetAccumulatedLayoutTransform()),
+						TestGeometry.GetAccumulatedRenderTransform()),
+					FSlateRotatedRect(TestGeometry.GetLayoutBoundingRect())
+				);
+
+				if (IsOverlappingSlateRotatedRect(WindowSpaceCoordinate, Params.Radius, WindowOrientedClipRect))
+				{
+					// For non-0 radii also record the distance to cursor's center so that we can pick the closest hit from the results.
+					const bool bNeedsDistanceSearch = Params.Radius > 0.0f;
+					const float DistSq = (bNeedsDistanceSearch) ? DistanceSqToSlateRotatedRect(WindowSpaceCoordinate, WindowOrientedClipRect) : 0.0f;
+					if (OutCandidatePosition)
+					{
+						*OutCandidatePosition = i;
+					}
+					return FIndexAndDistance(WidgetIndexes[i], DistSq);
+				}
+			}
+		}
+	}
+
+	return FIndexAndDistance();
+}
+
+const FHittestGrid::FCollapsedHittestGridArray& FHittestGrid::GetCollapsedHittestGrid() const
+{
+	bool bIsUpToDate = CollapsedGridsCache.Generation == HittestGridPrivate::AppendedGridsGeneration;
+	for (int32 Index = 0; bIsUpToDate && Index < CollapsedGridsCache.AppendedGrids.Num(); ++Index)
+	{
+		// Destroyed without being removed, see RemoveStaleAppendedHittestGrid
+		bIsUpToDate = CollapsedGridsCache.AppendedGrids[Index].IsValid();
+	}
+
+	if (!bIsUpToDate)
+	{
+		CollapsedGridsCache.Grids.Reset();
+		CollapsedGridsCache.AppendedGrids.Reset();
+		CollectCollapsedHittestGrid(CollapsedGridsCache.Grids, CollapsedGridsCache.AppendedGrids);
+		CollapsedGridsCache.Generation = HittestGridPrivate::AppendedGridsGeneration;
+
+#if UE_SLATE_HITTESTGRID_ARRAYSIZEMAX
+		HittestGrid_CollapsedHittestGridArraySizeMax = FMath::Max(CollapsedGridsCache.Grids.Num(), HittestGrid_CollapsedHittestGridArraySizeMax);
+#endif
+	}
+
+	return CollapsedGridsCache.Grids;
+}
+
+void FHittestGrid::CollectCollapsedHittestGrid(FCollapsedHittestGridArray& OutResult, FAppendedGridReferenceArray& OutAppendedGrids) const
+{
+	OutResult.Add(this);
+	for (const FAppendedGridData& AppendedGridData : AppendedGridArray)
+	{
+		if (const TSharedPtr<const FHittestGrid>& AppendedGrid = AppendedGridData.Grid.Pin())
+		{
+			if (ensure(!OutResult.Contains(AppendedGrid.Get()))) // Check for recursion
+			{
+				if (ensure(SameSize(AppendedGrid.Get())))
+				{
+					OutAppendedGrids.Add(AppendedGrid);
+					AppendedGrid->CollectCollapsedHittestGrid(OutResult, OutAppendedGrids);
+				}
+			}
+		}
+	}
+}
+
+#define UE_VERIFY_WIDGET_VALIDITE 0
+ const FHittestGrid::FCollapsedCell& FHittestGrid::GetCollapsedWidgets(const int32 X, const int32 Y) const
+ {
+	 const int32 CellIndex = Y * NumCells.X + X;
+	 check(Cells.IsValidIndex(CellIndex));
+	 FCollapsedCell& CollapsedCell = CollapsedCells[CellIndex];
+
+	 const FCollapsedHittestGridArray& AllHitTestGrids = GetCollapsedHittestGrid();
+
+	 // The list is still valid if the same grids are collapsed and none of their cells changed
+	 bool bIsUpToDate = CollapsedCell.GridVersions.Num() == AllHitTestGrids.Num();
+	 for (int32 GridIndex = 0; bIsUpToDate && GridIndex < AllHitTestGrids.Num(); ++GridIndex)
+	 {
+		 const FHittestGrid* HittestGrid = AllHitTestGrids[GridIndex];
+		 const FCollapsedCell::FGridVersion& GridVersion = CollapsedCell.GridVersions[GridIndex];
+		 bIsUpToDate = GridVersion.Grid == HittestGrid
+			 && GridVersion.CellVersion == HittestGrid->CellAt(X, Y).GetVersion()
+			 && GridVersion.RootCellVersion == HittestGrid->RootCell.GetVersion();
+	 }
+	 if (bIsUpToDate)
+	 {
+		 if (CollapsedCell.BoundsGeneration != HittestGridPrivate::HittestGeneration)
+		 {
+			 // Same widgets in the same order, some of them may have moved
+			 UpdateCollapsedBounds(CollapsedCell);
+		 }
+		 return CollapsedCell;
+	 }
+
+	 SCOPE_CYCLE_COUNTER(STAT_SlateHTG_GetCollapsedWidgets);
+
+	 FCollapsedWidgetsArray& OutResult = CollapsedCell.WidgetIndexes;
+	 OutResult.Reset();
+	 CollapsedCell.BuildVersion = HittestGridPrivate::MakeCellVersion();
+	 CollapsedCell.GridVersions.Reset();
+
+	 {
+		 for (const FHittestGrid* HittestGrid : AllHitTestGrids)
+		 {
+			 const FCell& Cell = HittestGrid->CellAt(X, Y);
+			 CollapsedCell.GridVersions.Add({ HittestGrid, Cell.GetVersion(), HittestGrid->RootCell.GetVersion() });
+			 for (const FCell* SourceCell : { &HittestGrid->RootCell, &Cell })
+			 {
+				 for (int32 WidgetIndex : SourceCell->GetWidgetIndexes())
+				 {
+#if UE_VERIFY_WIDGET_VALIDITE
+					 ensureAlways(HittestGrid->WidgetArray.IsValidIndex(WidgetIndex));
+#endif
+					 OutResult.Emplace(HittestGrid, WidgetIndex);
+				 }
+			 }
+		 }
+
+		 OutResult.StableSort([](const FWidgetIndex& A, const FWidgetIndex& B)
+			 {
+				 const FWidgetData& WidgetDataA = A.GetWidgetData();
+				 const FWidgetData& WidgetDataB = B.GetWidgetData();
+				 return WidgetDataA.PrimarySort < WidgetDataB.PrimarySort || (WidgetDataA.PrimarySort == WidgetDataB.PrimarySort && WidgetDataA.SecondarySort < WidgetDataB.SecondarySort);
+			 });
+	 }
+
+	 UpdateCollapsedBounds(CollapsedCell);
+
+#if UE_SLATE_HITTESTGRID_ARRAYSIZEMAX
+	 HittestGrid_CollapsedWidgetsArraySizeMax = FMath::Max(OutResult.Num(), HittestGrid_CollapsedWidgetsArraySizeMax);
+#endif
+	 return CollapsedCell;
+ }
+
+void FHittestGrid::UpdateCollapsedBounds(FCollapsedCell& CollapsedCell)
+{
+	const int32 NumWidgets = CollapsedCell.WidgetIndexes.Num();
+	const int32 NumPadded = Align(NumWidgets, 4);
+
+	for (TArray<float, TAlignedHeapAllocator<16>>& BoundsArray : CollapsedCell.Bounds)
+	{
+		BoundsArray.SetNumUninitialized(NumPadded, false);
+	}
+	float* MinX = CollapsedCell.Bounds[0].GetData();
+	float* MinY = CollapsedCell.Bounds[1].GetData();
+	float* MaxX = CollapsedCell.Bounds[2].GetData();
+	float* MaxY = CollapsedCell.Bounds[3].GetData();
+
+	for (int32 Index = 0; Index < NumWidgets; ++Index)
+	{
+		const FSlateRect& Rect = CollapsedCell.WidgetIndexes[Index].GetWidgetData().BoundingRect;
+		MinX[Index] = Rect.Left;
+		MinY[Index] = Rect.Top;
+		MaxX[Index] = Rect.Right;
+		MaxY[Index] = Rect.Bottom;
+	}
+
+	// The padding never overlaps the cursor
+	for (int32 Index = NumWidgets; Index < NumPadded; ++Index)
+	{
+		MinX[Index] = MinY[Index] = MAX_flt;
+		MaxX[Index] = MaxY[Index] = -MAX_flt;
+	}
+
+	CollapsedCell.BoundsGeneration = HittestGridPrivate::HittestGeneration;
+}
+
+void FHittestGrid::MarkCellsSortDirty(const FWidgetData& WidgetData)
+{
+	if (WidgetData.bInRootCell)
+	{
+		RootCell.MarkSortDirty();
+		return;
+	}
+
+	for (int32 XIndex = WidgetData.UpperLeftCell.X; XIndex <= WidgetData.LowerRightCell.X; ++XIndex)
+	{
+		for (int32 YIndex = WidgetData.UpperLeftCell.Y; YIndex <= WidgetData.LowerRightCell.Y; ++YIndex)
+		{
+			if (IsValidCellCoord(XIndex, YIndex))
+			{
+				CellAt(XIndex, YIndex).MarkSortDirty();
+			}
+		}
+	}
+}
+#undef UE_VERIFY_WIDGET_VALIDITE
+
+void FHittestGrid::RemoveStaleAppendedHittestGrid()
+{
+	for (int32 AppendedGridIndex = AppendedGridArray.Num() - 1; AppendedGridIndex >= 0; --AppendedGridIndex)
+	{
+		bool bToRemove = false;
+		const TWeakPtr<const FHittestGrid>& WeakAppendedGrid = AppendedGridArray[AppendedGridIndex].Grid;
+		if (const TSharedPtr<const FHittestGrid>& AppendedGrid = WeakAppendedGrid.Pin())
+		{
+			if (!SameSize(AppendedGrid.Get()))
+			{
+				bToRemove = true;
+			}
+		}
+		else
+		{
+			// grid was removed without notifying the SlateInvalidationRoot.
+			//That can happened when the widget containing the owner of the grid is removed in the same frame as it was added.
+			bToRemove = true;
+		}
+
+		if (bToRemove)
+		{
+			AppendedGridArray.RemoveAtSwap(AppendedGridIndex);
+			HittestGridPrivate::MarkHittestChanged();
+			HittestGridPrivate::MarkAppendedGridsChanged();
+		}
+	}
+}
+
+#if WITH_SLATE_DEBUGGING
+void FHittestGrid::LogGrid() const
+{
+	FString TempString;
+	for (int32 y = 0; y < NumCells.Y; ++y)
+	{
+		for (int x = 0; x < NumCells.X; ++x)
+		{
+			TempString += "\t";
+			TempString += "[";
+			for (int32 i : CellAt(x, y).GetWidgetIndexes())
+			{
+				TempString += FString::Printf(TEXT("%d,"), i);
+			}
+			TempString += "]";
+		}
+		TempString += "\n";
+	}
+
+	TempString += "Root [";
+	for (int32 i : RootCell.GetWidgetIndexes())
+	{
+		TempString += FString::Printf(TEXT("%d,"), i);
+	}
+	TempString += "]\n";
+
+	UE_LOG(LogHittestDebug, Warning, TEXT("\n%s"), *TempString);
+
+	for (TSparseArray<FWidgetData>::TConstIterator It(WidgetArray); It; ++It)
+	{
+		const FWidgetData& CurWidgetData = *It;
+		const TSharedPtr<SWidget> CachedWidget = CurWidgetData.GetWidget();
+		UE_LOG(LogHittestDebug, Warning, TEXT("  [%d][%d][%d] => %s @ %s"),
+			It.GetIndex(),
+			CurWidgetData.PrimarySort,
+			CachedWidget.IsValid() ? *CachedWidget->ToString() : TEXT("Invalid Widget"),
+			CachedWidget.IsValid() ? *CachedWidget->GetPaintSpaceGeometry().ToString() : TEXT("Invalid Widget"));
+	}
+}
+
+constexpr FLinearColor GetUserColorFromIndex(int32 Index)
+{
+	switch (Index)
+	{
+	case 0:
+		return FLinearColor::Red;
+	case 1:
+		return FLinearColor::Green;
+	case 2:
+		return FLinearColor::Blue;
+	case 3:
+		return FLinearColor::Yellow;
+	default:
+		return FLinearColor::White;
+	}
+};
+
+
+void FHittestGrid::DisplayGrid(int32 InLayer, const FGeometry& AllottedGeometry, FSlateWindowElementList& WindowElementList, EDisplayGridFlags DisplayFlags) const
+{
+	static const FSlateBrush* FocusRectangleBrush = FCoreStyle::Get().GetBrush(TEXT("FocusRectangle"));
+	static const FSlateBrush* BorderBrush = FCoreStyle::Get().GetBrush(TEXT("Border"));
+
+	const FSlateBrush* Brush = EnumHasAnyFlags(DisplayFlags, EDisplayGridFlags::UseFocusBrush) ? FocusRectangleBrush : BorderBrush;
+
+	auto DisplayGrid = [&] (const FHittestGrid* HittestGrid)
+	{
+		for (TSparseArray<FWidgetData>::TConstIterator It(HittestGrid->WidgetArray); It; ++It)
+		{
+			const FWidgetData& CurWidgetData = *It;
+			const TSharedPtr<SWidget> CachedWidget = CurWidgetData.GetWidget();
+			if (ensure(CachedWidget.IsValid())) // Widget should always be valid
+			{
+				if (EnumHasAnyFlags(DisplayFlags, EDisplayGridFlags::HideDisabledWidgets) && !CachedWidget->IsEnabled())
+				{
+					continue;
+				}
+				if (EnumHasAnyFlags(DisplayFlags, EDisplayGridFlags::HideUnsupportedKeyboardFocusWidgets) && !CachedWidget->SupportsKeyboardFocus())
+				{
+					continue;
+				}
+
+				FSlateDrawElement::MakeBox(
+					WindowElementList,
+					InLayer,
+					CachedWidget->GetPaintSpaceGeometry().ToPaintGeometry(),
+					Brush,
+					ESlateDrawEffect::None,
+					GetUserColorFromIndex(CurWidgetData.UserIndex)
+				);
+			}
+		}
+	};
+
+	const FCollapsedHittestGridArray& AllHitTestGrids = GetCollapsedHittestGrid();
+	for(const FHittestGrid* HittestGrid : AllHitTestGrids)
+	{
+		DisplayGrid(HittestGrid);
+	}
+
+	// Appended grid should always be valid
+	FCollapsedHittestGridArray TestHitTestGrids;
+	TestHitTestGrids.Add(this);
+	for (int32 Index = 0; Index < TestHitTestGrids.Num(); ++Index)
+	{
+		const FHittestGrid* Grid = TestHitTestGrids[Index];
+		for (const FAppendedGridData& OtherGridData : Grid->AppendedGridArray)
+		{
+			const TSharedPtr<const FHittestGrid> OtherGridPin = OtherGridData.Grid.Pin();
+			if (ensureAlways(OtherGridPin.IsValid()))
+			{
+				TestHitTestGrids.Add(&*OtherGridPin);
+			}
+		}
+	}
+}
+#endif // WITH_SLATE_DEBUGGING
+
+// HankShu-inkiu0@gmail.com add ClickClip Start
+
+int32* FHittestGrid::FindClickClipBlockIndex(const SWidget* InWidget)
+{
+	if (const int32* WidgetIndex = WidgetMap.Find(InWidget))
+	{
+		return &WidgetArray[*WidgetIndex].ClickClipBlockIndex;
+	}
+	return nullptr;
+}
+
+void FHittestGrid::ReleaseClickClipBlock(int32& InOutBlockIndex)
+{
+	if (InOutBlockIndex != INDEX_NONE)
+	{
+		ClickClipBlocks.RemoveAt(InOutBlockIndex);
+		InOutBlockIndex = INDEX_NONE;
+	}
+}
+
+void FHittestGrid::AddClickClip(const SWidget* InWidget, const TSharedPtr<FSlateClickClippingState>& InClickClip)
+{
+	int32* BlockIndex = FindClickClipBlockIndex(InWidget);
+	if (BlockIndex == nullptr)
+	{
+		// Not hit test visible, nothing in the grid would ever release a block keyed by its address
+		return;
+	}
+	if (*BlockIndex == INDEX_NONE)
+	{
+		const int32 PreviousMax = ClickClipBlocks.Max();
+		*BlockIndex = ClickClipBlocks.Add(FClickClipBlock());
+		if (ClickClipBlocks.Max() != PreviousMax)
+		{
+			INC_DWORD_STAT(STAT_MaskWidgetPaintAllocations);
+		}
+	}
+
+	FClickClipBlock& ClickClips = ClickClipBlocks[*BlockIndex];
+	const int32 ClipIndex = InClickClip->GetClipIndex();
+	const int32 ExistingIndex = ClickClips.IndexOfByPredicate([ClipIndex](const TSharedPtr<FSlateClickClippingState>& ClickClip) { return ClickClip->GetClipIndex() == ClipIndex; });
+	if (ExistingIndex != INDEX_NONE)
+	{
+		if (ClickClips[ExistingIndex] != InClickClip)
+		{
+			HittestGridPrivate::MarkHittestChanged();
+			ClickClips[ExistingIndex] = InClickClip;
+		}
+	}
+	else
+	{
+		HittestGridPrivate::MarkHittestChanged();
+		const int32 PreviousMax = ClickClips.Max();
+		ClickClips.Add(InClickClip);
+		if (ClickClips.Max() != PreviousMax)
+		{
+			// Past the inline clips of the block
+			INC_DWORD_STAT(STAT_MaskWidgetPaintAllocations);
+		}
+	}
+}
+
+void FHittestGrid::RemoveClickClip(const SWidget* InWidget, int32 ClipIndex)
+{
+	int32* BlockIndex = FindClickClipBlockIndex(InWidget);
+	if (BlockIndex && *BlockIndex != INDEX_NONE)
+	{
+		FClickClipBlock& ClickClips = ClickClipBlocks[*BlockIndex];
+		if (ClickClips.RemoveAllSwap([ClipIndex](const TSharedPtr<FSlateClickClippingState>& ClickClip) { return ClickClip->GetClipIndex() == ClipIndex; }) > 0)
+		{
+			HittestGridPrivate::MarkHittestChanged();
+		}
+		if (ClickClips.Num() == 0)
+		{
+			// Back to the no ClickClip fast path
+			ReleaseClickClipBlock(*BlockIndex);
+		}
+	}
+}
+
+bool FHittestGrid::IsThroughClickClip(const FVector2D& WindowSpaceCoordinate, const FWidgetData& ClickWidgetData) const
+{
+	const FClickClipBlock& ClickClips = ClickClipBlocks[ClickWidgetData.ClickClipBlockIndex];
+
+	// Click through only when every ClickClip under the point lets it through
+	bool bHitClip = false;
+	for (const TSharedPtr<FSlateClickClippingState>& ClickClip : ClickClips)
+	{
+		const EClickClipHit Hit = ClickClip->Classify(WindowSpaceCoordinate);
+		if (Hit == EClickClipHit::InsideBlocked)
+		{
+			return false;
+		}
+		bHitClip |= Hit == EClickClipHit::InsideThrough;
+	}
+
+	return bHitClip;
+}
+
+// HankShu-inkiu0@gmail.com add ClickClip end
+
+#undef UE_SLATE_HITTESTGRID_ARRAYSIZEMAX
+#undef LOCTEXT_NAMESPACE
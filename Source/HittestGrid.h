@@ -1,328 +1,506 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Layout/SlateRect.h"
-#include "Layout/ArrangedWidget.h"
-#include "Layout/Clipping.h"
-#include "Input/Events.h"
-#include "Widgets/SWidget.h"
-#include "Layout/SlateClickClippingState.h"
-
-class FArrangedChildren;
-
-class ICustomHitTestPath
-{
-public:
-	virtual ~ICustomHitTestPath(){}
-
-	virtual TArray<FWidgetAndPointer> GetBubblePathAndVirtualCursors( const FGeometry& InGeometry, FVector2D DesktopSpaceCoordinate, bool bIgnoreEnabledStatus ) const = 0;
-
-	virtual void ArrangeCustomHitTestChildren( FArrangedChildren& ArrangedChildren ) const = 0;
-
-	virtual TSharedPtr<struct FVirtualPointerPosition> TranslateMouseCoordinateForCustomHitTestChild( const TSharedRef<SWidget>& ChildWidget, const FGeometry& ViewportGeometry, const FVector2D& ScreenSpaceMouseCoordinate, const FVector2D& LastScreenSpaceMouseCoordinate ) const = 0;
-};
-
-class SLATECORE_API FHittestGrid : public FNoncopyable
-{
-public:
-
-	FHittestGrid();
-
-	/**
-	 * Given a Slate Units coordinate in virtual desktop space, perform a hittest
-	 * and return the path along which the corresponding event would be bubbled.
-	 */
-	TArray<FWidgetAndPointer> GetBubblePath(FVector2D DesktopSpaceCoordinate, float CursorRadius, bool bIgnoreEnabledStatus, int32 UserIndex = INDEX_NONE);
-
-	/**
-	 * Set the position and size of the hittest area in desktop coordinates
-	 *
-	 * @param HittestPositionInDesktop	The position of this hit testing area in desktop coordinates.
-	 * @param HittestDimensions			The dimensions of this hit testing area.
-	 *
-	 * @return      Returns true if a clear of the hittest grid was required. 
-	 */
-	bool SetHittestArea(const FVector2D& HittestPositionInDesktop, const FVector2D& HittestDimensions, const FVector2D& HitestOffsetInWindow = FVector2D::ZeroVector);
-
-	/** Insert custom hit test data for a widget already in the grid */
-	void InsertCustomHitTestPath(const TSharedRef<SWidget> InWidget, TSharedRef<ICustomHitTestPath> CustomHitTestPath);
-
-	/** Sets the current slate user index that should be associated with any added widgets */
-	void SetUserIndex(int32 UserIndex) { CurrentUserIndex = UserIndex; }
-
-	/** Set the culling rect to be used by the parent grid (in case we are appended to another grid). */
-	void SetCullingRect(const FSlateRect& InCullingRect) { CullingRect = InCullingRect; }
-
-	/** Set the owner SWidget to be used by the parent grid (in case we are appended to another grid). */
-	void SetOwner(const SWidget* InOwner) { check(Owner == nullptr || Owner == InOwner); Owner = InOwner; }
-
-	/** Gets current slate user index that should be associated with any added widgets */
-	int32 GetUserIndex() const { return CurrentUserIndex; }
-
-	/**
-	 * Finds the next focusable widget by searching through the hit test grid
-	 *
-	 * @param StartingWidget  This is the widget we are starting at, and navigating from.
-	 * @param Direction       The direction we should search in.
-	 * @param NavigationReply The Navigation Reply to specify a boundary rule for the search.
-	 * @param RuleWidget      The Widget that is applying the boundary rule, used to get the bounds of the Rule.
-	 */
-	TSharedPtr<SWidget> FindNextFocusableWidget(const FArrangedWidget& StartingWidget, const EUINavigation Direction, const FNavigationReply& NavigationReply, const FArrangedWidget& RuleWidget, int32 UserIndex);
-
-	FVector2D GetGridSize() const { return GridSize; }
-	FVector2D GetGridOrigin() const { return GridOrigin; }
-	FVector2D GetGridWindowOrigin() const { return GridWindowOrigin; }
-
-	// HankShu-inkiu0@gmail.com add ClickClip Start
-	void AddClickClip(const SWidget* InWidget, const TSharedPtr<FSlateClickClippingState>& InClickClip);
-	// HankShu-inkiu0@gmail.com add ClickClip end
-
-	/** Clear the grid */
-	void Clear();
-
-	/** Add SWidget from the HitTest Grid */
-	void AddWidget(const TSharedRef<SWidget>& InWidget, int32 InBatchPriorityGroup, int32 InLayerId, int32 InSecondarySort);
-
-	/** Remove SWidget from the HitTest Grid */
-	void RemoveWidget(const TSharedRef<SWidget>& InWidget);
-
-	/** Remove SWidget from the HitTest Grid */
-	void RemoveWidget(const SWidget* InWidget);
-
-	/** Append an already existing grid that occupy the same space. */
-	UE_DEPRECATED(4.26, "Deprecated. Use the FHittestGrid::AddGrid method instead")
-	void AppendGrid(FHittestGrid& OtherGrid) {}
-
-	/**
-	 * Add an already existing grid that occupy the same space.
-	 * The grid needs to have an owner, not be this grid and occupy the same space as this grid.
-	 */
-	void AddGrid(const TSharedRef<const FHittestGrid>& OtherGrid);
-
-	/** Remove a grid that was appended. */
-	void RemoveGrid(const TSharedRef<const FHittestGrid>& OtherGrid);
-
-	/** Remove a grid that was appended. */
-	void RemoveGrid(const SWidget* OtherGridOwner);
-
-	struct FDebuggingFindNextFocusableWidgetArgs
-	{
-		struct FWidgetResult
-		{
-			const TSharedPtr<const SWidget> Widget;
-			const FText Result;
-			FWidgetResult(const TSharedPtr<const SWidget>& InWidget, FText InResult)
-				: Widget(InWidget), Result(InResult) {}
-		};
-		const FArrangedWidget StartingWidget;
-		const EUINavigation Direction;
-		const FNavigationReply NavigationReply;
-		const FArrangedWidget RuleWidget;
-		const int32 UserIndex;
-		const TSharedPtr<const SWidget> Result;
-		TArray<FWidgetResult> IntermediateResults;
-	};
-
-#if WITH_SLATE_DEBUGGING
-	DECLARE_MULTICAST_DELEGATE_TwoParams(FDebuggingFindNextFocusableWidget, const FHittestGrid* /*HittestGrid*/, const FDebuggingFindNextFocusableWidgetArgs& /*Info*/);
-	static FDebuggingFindNextFocusableWidget OnFindNextFocusableWidgetExecuted;
-
-	void LogGrid() const;
-
-	enum class EDisplayGridFlags
-	{
-		None = 0,
-		HideDisabledWidgets = 1 << 0,					// Hide hit box for widgets that have IsEnabled false
-		HideUnsupportedKeyboardFocusWidgets = 1 << 1,	// Hide hit box for widgets that have SupportsKeyboardFocus false
-		UseFocusBrush = 1 << 2,
-	};
-	void DisplayGrid(int32 InLayer, const FGeometry& AllottedGeometry, FSlateWindowElementList& WindowElementList, EDisplayGridFlags DisplayFlags = EDisplayGridFlags::UseFocusBrush) const;
-#endif
-
-private:
-	/**
-	 * Widget Data we maintain internally store along with the widget reference
-	 */
-	struct FWidgetData
-	{
-		FWidgetData(TSharedRef<SWidget> InWidget, const FIntPoint& InUpperLeftCell, const FIntPoint& InLowerRightCell, int64 InPrimarySort, int32 InSecondarySort, int32 InUserIndex)
-			: WeakWidget(InWidget)
-			, UpperLeftCell(InUpperLeftCell)
-			, LowerRightCell(InLowerRightCell)
-			, PrimarySort(InPrimarySort)
-			, SecondarySort(InSecondarySort)
-			, UserIndex(InUserIndex)
-		{}
-		TWeakPtr<SWidget> WeakWidget;
-		TWeakPtr<ICustomHitTestPath> CustomPath;
-		FIntPoint UpperLeftCell;
-		FIntPoint LowerRightCell;
-		int64 PrimarySort;
-		int32 SecondarySort;
-		int32 UserIndex;
-
-		TSharedPtr<SWidget> GetWidget() const { return WeakWidget.Pin(); }
-	};
-
-	struct FWidgetIndex
-	{
-		FWidgetIndex()
-			: Grid(nullptr)
-			, WidgetIndex(INDEX_NONE)
-		{}
-		FWidgetIndex(const FHittestGrid* InHittestGrid, int32 InIndex)
-			: Grid(InHittestGrid)
-			, WidgetIndex(InIndex)
-		{}
-		bool IsValid() const { return Grid != nullptr && Grid->WidgetArray.IsValidIndex(WidgetIndex); }
-		const FWidgetData& GetWidgetData() const;
-		const FSlateRect& GetCullingRect() const { return Grid->CullingRect; }
-		const FHittestGrid* GetGrid() const { return Grid; }
-
-	private:
-		const FHittestGrid* Grid;
-		int32 WidgetIndex;
-	};
-
-	struct FIndexAndDistance : FWidgetIndex
-	{
-		FIndexAndDistance()
-			: FWidgetIndex()
-			, DistanceSqToWidget(0)
-		{}
-		FIndexAndDistance(FWidgetIndex WidgetIndex, float InDistanceSq)
-			: FWidgetIndex(WidgetIndex)
-			, DistanceSqToWidget(InDistanceSq)
-		{}
-		float GetDistanceSqToWidget() const { return DistanceSqToWidget; }
-
-	private:
-		float DistanceSqToWidget;
-	};
-
-	struct FGridTestingParams;
-
-	/**
-	 * All the available space is partitioned into Cells.
-	 * Each Cell contains a list of widgets that overlap the cell.
-	 * The list is ordered from back to front.
-	 */
-	struct FCell
-	{
-	public:
-		FCell() = default;
-
-		void AddIndex(int32 WidgetIndex);
-		void RemoveIndex(int32 WidgetIndex);
-
-		const TArray<int32>& GetWidgetIndexes() const { return WidgetIndexes; }
-		
-	private:
-		TArray<int32> WidgetIndexes;
-	};
-
-	struct FAppendedGridData
-	{
-		FAppendedGridData(const SWidget* InCachedOwner, const TWeakPtr<const FHittestGrid>& InGrid)
-			 : CachedOwner(InCachedOwner), Grid(InGrid)
-		{ }
-		const SWidget* CachedOwner; // Cached owner of the grid
-		TWeakPtr<const FHittestGrid> Grid;
-	};
-
-	//~ Helper functions
-	bool IsValidCellCoord(const FIntPoint& CellCoord) const;
-	bool IsValidCellCoord(const int32 XCoord, const int32 YCoord) const;
-	void ClearInternal(int32 TotalCells);
-
-	/** Return the Index and distance to a hit given the testing params */
-	FIndexAndDistance GetHitIndexFromCellIndex(const FGridTestingParams& Params) const;
-
-	/** @returns true if the child is a paint descendant of the provided Parent. */
-	bool IsDescendantOf(const TSharedRef<SWidget> Parent, const FWidgetData& ChildData) const;
-
-	/** Utility function for searching for the next focusable widget. */
-	template<typename TCompareFunc, typename TSourceSideFunc, typename TDestSideFunc>
-	TSharedPtr<SWidget> FindFocusableWidget(const FSlateRect WidgetRect, const FSlateRect SweptRect, int32 AxisIndex, int32 Increment, const EUINavigation Direction, const FNavigationReply& NavigationReply, TCompareFunc CompareFunc, TSourceSideFunc SourceSideFunc, TDestSideFunc DestSideFunc, int32 UserIndex, TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult>* IntermediatedResultPtr) const;
-
-	/** Constrains a float position into the grid coordinate. */
-	FIntPoint GetCellCoordinate(FVector2D Position) const;
-
-	/** Access a cell at coordinates X, Y. Coordinates are row and column indexes. */
-	FORCEINLINE_DEBUGGABLE FCell& CellAt(const int32 X, const int32 Y)
-	{
-		checkfSlow((Y*NumCells.X + X) < Cells.Num(), TEXT("HitTestGrid CellAt() failed: X= %d Y= %d NumCells.X= %d NumCells.Y= %d Cells.Num()= %d"), X, Y, NumCells.X, NumCells.Y, Cells.Num());
-		return Cells[Y*NumCells.X + X];
-	}
-
-	/** Access a cell at coordinates X, Y. Coordinates are row and column indexes. */
-	FORCEINLINE_DEBUGGABLE const FCell& CellAt( const int32 X, const int32 Y ) const
-	{
-		checkfSlow((Y*NumCells.X + X) < Cells.Num(), TEXT("HitTestGrid CellAt() failed: X= %d Y= %d NumCells.X= %d NumCells.Y= %d Cells.Num()= %d"), X, Y, NumCells.X, NumCells.Y, Cells.Num());
-		return Cells[Y*NumCells.X + X];
-	}
-
-	// HankShu-inkiu0@gmail.com add ClickClip Start
-	/** ClickClip area can be clicked through */
-	bool IsThroughClickClip(const FGridTestingParams& Params, const SWidget* ClickWidget) const;
-
-	TMap<const SWidget*, TArray<TSharedPtr<FSlateClickClippingState>>> ClickClipMap;
-	// HankShu-inkiu0@gmail.com add ClickClip end
-
-	/** Is the other grid compatible with this grid. */
-	bool CanBeAppended(const FHittestGrid* OtherGrid) const;
-
-	/** Are both grid of the same size. */
-	bool SameSize(const FHittestGrid* OtherGrid) const;
-
-	using FCollapsedHittestGridArray = TArray<const FHittestGrid*, TInlineAllocator<16>>;
-	/** Get all the hittest grid appended to this grid. */
-	void GetCollapsedHittestGrid(FCollapsedHittestGridArray& OutResult) const;
-
-	using FCollapsedWidgetsArray = TArray<FWidgetIndex, TInlineAllocator<100>>;
-	/** Return the list of all the widget in that cell. */
-	void GetCollapsedWidgets(FCollapsedWidgetsArray& Out, const int32 X, const int32 Y) const;
-
-	/** Remove appended hittest grid that are not valid anymore. */
-	void RemoveStaleAppendedHittestGrid();
-
-private:
-	/** Map of all the widgets currently in the hit test grid to their stable index. */
-	TMap<const SWidget*, int32> WidgetMap;
-
-	/** Stable indexed sparse array of all the widget data we track. */
-	TSparseArray<FWidgetData> WidgetArray;
-
-	/** The cells that make up the space partition. */
-	TArray<FCell> Cells;
-
-	/** The collapsed grid cached untiled it's dirtied. */
-	TArray<FAppendedGridData> AppendedGridArray;
-
-	/** A grid needs a owner to be appended. */
-	const SWidget* Owner;
-
-	/** Culling Rect used when the widget was painted. */
-	FSlateRect CullingRect;
-
-	/** The size of the grid in cells. */
-	FIntPoint NumCells;
-
-	/** Where the 0,0 of the upper-left-most cell corresponds to in desktop space. */
-	FVector2D GridOrigin;
-
-	/** Where the 0,0 of the upper-left-most cell corresponds to in window space. */
-	FVector2D GridWindowOrigin;
-
-	/** The Size of the current grid. */
-	FVector2D GridSize;
-
-	/** The current slate user index that should be associated with any added widgets */
-	int32 CurrentUserIndex;
-};
-
-#if WITH_SLATE_DEBUGGING
-ENUM_CLASS_FLAGS(FHittestGrid::EDisplayGridFlags);
-#endif
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+#include "Layout/ArrangedWidget.h"
+#include "Layout/Clipping.h"
+#include "Input/Events.h"
+#include "Widgets/SWidget.h"
+#include "Layout/SlateClickClippingState.h"
+
+class FArrangedChildren;
+
+class ICustomHitTestPath
+{
+public:
+	virtual ~ICustomHitTestPath(){}
+
+	virtual TArray<FWidgetAndPointer> GetBubblePathAndVirtualCursors( const FGeometry& InGeometry, FVector2D DesktopSpaceCoordinate, bool bIgnoreEnabledStatus ) const = 0;
+
+	virtual void ArrangeCustomHitTestChildren( FArrangedChildren& ArrangedChildren ) const = 0;
+
+	virtual TSharedPtr<struct FVirtualPointerPosition> TranslateMouseCoordinateForCustomHitTestChild( const TSharedRef<SWidget>& ChildWidget, const FGeometry& ViewportGeometry, const FVector2D& ScreenSpaceMouseCoordinate, const FVector2D& LastScreenSpaceMouseCoordinate ) const = 0;
+};
+
+class SLATECORE_API FHittestGrid : public FNoncopyable
+{
+public:
+
+	FHittestGrid();
+
+	/**
+	 * Given a Slate Units coordinate in virtual desktop space, perform a hittest
+	 * and return the path along which the corresponding event would be bubbled.
+	 */
+	TArray<FWidgetAndPointer> GetBubblePath(FVector2D DesktopSpaceCoordinate, float CursorRadius, bool bIgnoreEnabledStatus, int32 UserIndex = INDEX_NONE);
+
+	/** Deep enough for most widget trees without touching the heap */
+	using FBubblePathBuffer = TArray<FWidgetAndPointer, TInlineAllocator<32>>;
+
+	/** GetBubblePath filling a caller provided buffer, keep it around between events to avoid allocating. */
+	void GetBubblePath(FVector2D DesktopSpaceCoordinate, float CursorRadius, bool bIgnoreEnabledStatus, int32 UserIndex, FBubblePathBuffer& OutPath);
+
+	/**
+	 * Batch version of GetBubblePath for several pointers, OutPaths[i] is the path of DesktopSpaceCoordinates[i].
+	 * Points in the same cell share the sorted candidate list and hits under the same parents share the parent walk.
+	 */
+	void GetBubblePaths(TArrayView<const FVector2D> DesktopSpaceCoordinates, TArray<TArray<FWidgetAndPointer>>& OutPaths, bool bIgnoreEnabledStatus, int32 UserIndex = INDEX_NONE);
+
+	/**
+	 * Set the position and size of the hittest area in desktop coordinates
+	 *
+	 * @param HittestPositionInDesktop	The position of this hit testing area in desktop coordinates.
+	 * @param HittestDimensions			The dimensions of this hit testing area.
+	 *
+	 * @return      Returns true if a clear of the hittest grid was required. 
+	 */
+	bool SetHittestArea(const FVector2D& HittestPositionInDesktop, const FVector2D& HittestDimensions, const FVector2D& HitestOffsetInWindow = FVector2D::ZeroVector);
+
+	/** Insert custom hit test data for a widget already in the grid */
+	void InsertCustomHitTestPath(const TSharedRef<SWidget> InWidget, TSharedRef<ICustomHitTestPath> CustomHitTestPath);
+
+	/** Sets the current slate user index that should be associated with any added widgets */
+	void SetUserIndex(int32 UserIndex) { CurrentUserIndex = UserIndex; }
+
+	/** Set the culling rect to be used by the parent grid (in case we are appended to another grid). */
+	void SetCullingRect(const FSlateRect& InCullingRect) { CullingRect = InCullingRect; }
+
+	/** Set the owner SWidget to be used by the parent grid (in case we are appended to another grid). */
+	void SetOwner(const SWidget* InOwner) { check(Owner == nullptr || Owner == InOwner); Owner = InOwner; }
+
+	/** Gets current slate user index that should be associated with any added widgets */
+	int32 GetUserIndex() const { return CurrentUserIndex; }
+
+	/**
+	 * Finds the next focusable widget by searching through the hit test grid
+	 *
+	 * @param StartingWidget  This is the widget we are starting at, and navigating from.
+	 * @param Direction       The direction we should search in.
+	 * @param NavigationReply The Navigation Reply to specify a boundary rule for the search.
+	 * @param RuleWidget      The Widget that is applying the boundary rule, used to get the bounds of the Rule.
+	 */
+	TSharedPtr<SWidget> FindNextFocusableWidget(const FArrangedWidget& StartingWidget, const EUINavigation Direction, const FNavigationReply& NavigationReply, const FArrangedWidget& RuleWidget, int32 UserIndex);
+
+	FVector2D GetGridSize() const { return GridSize; }
+	FVector2D GetGridOrigin() const { return GridOrigin; }
+	FVector2D GetGridWindowOrigin() const { return GridWindowOrigin; }
+
+	// HankShu-inkiu0@gmail.com add ClickClip Start
+	/** Register a ClickClip of InWidget, replaces the one registered with the same clip index. Ignored if InWidget isn't in the grid. */
+	void AddClickClip(const SWidget* InWidget, const TSharedPtr<FSlateClickClippingState>& InClickClip);
+
+	/** Unregister the ClickClip of InWidget with ClipIndex */
+	void RemoveClickClip(const SWidget* InWidget, int32 ClipIndex);
+	// HankShu-inkiu0@gmail.com add ClickClip end
+
+	/** Clear the grid */
+	void Clear();
+
+	/** Add SWidget from the HitTest Grid */
+	void AddWidget(const TSharedRef<SWidget>& InWidget, int32 InBatchPriorityGroup, int32 InLayerId, int32 InSecondarySort);
+
+	/** Remove SWidget from the HitTest Grid */
+	void RemoveWidget(const TSharedRef<SWidget>& InWidget);
+
+	/** Remove SWidget from the HitTest Grid */
+	void RemoveWidget(const SWidget* InWidget);
+
+	/** Append an already existing grid that occupy the same space. */
+	UE_DEPRECATED(4.26, "Deprecated. Use the FHittestGrid::AddGrid method instead")
+	void AppendGrid(FHittestGrid& OtherGrid) {}
+
+	/**
+	 * Add an already existing grid that occupy the same space.
+	 * The grid needs to have an owner, not be this grid and occupy the same space as this grid.
+	 */
+	void AddGrid(const TSharedRef<const FHittestGrid>& OtherGrid);
+
+	/** Remove a grid that was appended. */
+	void RemoveGrid(const TSharedRef<const FHittestGrid>& OtherGrid);
+
+	/** Remove a grid that was appended. */
+	void RemoveGrid(const SWidget* OtherGridOwner);
+
+	struct FDebuggingFindNextFocusableWidgetArgs
+	{
+		struct FWidgetResult
+		{
+			const TSharedPtr<const SWidget> Widget;
+			const FText Result;
+			FWidgetResult(const TSharedPtr<const SWidget>& InWidget, FText InResult)
+				: Widget(InWidget), Result(InResult) {}
+		};
+		const FArrangedWidget StartingWidget;
+		const EUINavigation Direction;
+		const FNavigationReply NavigationReply;
+		const FArrangedWidget RuleWidget;
+		const int32 UserIndex;
+		const TSharedPtr<const SWidget> Result;
+		TArray<FWidgetResult> IntermediateResults;
+	};
+
+#if WITH_SLATE_DEBUGGING
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FDebuggingFindNextFocusableWidget, const FHittestGrid* /*HittestGrid*/, const FDebuggingFindNextFocusableWidgetArgs& /*Info*/);
+	static FDebuggingFindNextFocusableWidget OnFindNextFocusableWidgetExecuted;
+
+	void LogGrid() const;
+
+	enum class EDisplayGridFlags
+	{
+		None = 0,
+		HideDisabledWidgets = 1 << 0,					// Hide hit box for widgets that have IsEnabled false
+		HideUnsupportedKeyboardFocusWidgets = 1 << 1,	// Hide hit box for widgets that have SupportsKeyboardFocus false
+		UseFocusBrush = 1 << 2,
+	};
+	void DisplayGrid(int32 InLayer, const FGeometry& AllottedGeometry, FSlateWindowElementList& WindowElementList, EDisplayGridFlags DisplayFlags = EDisplayGridFlags::UseFocusBrush) const;
+#endif
+
+private:
+	/** A widget of a bubble path and its desktop space geometry */
+	struct FAncestorEntry
+	{
+		TWeakPtr<SWidget> Widget;
+		FGeometry Geometry;
+	};
+
+	/**
+	 * Widget Data we maintain internally store along with the widget reference
+	 */
+	struct FWidgetData
+	{
+		FWidgetData(TSharedRef<SWidget> InWidget, const FIntPoint& InUpperLeftCell, const FIntPoint& InLowerRightCell, int64 InPrimarySort, int32 InSecondarySort, int32 InUserIndex)
+			: WeakWidget(InWidget)
+			, UpperLeftCell(InUpperLeftCell)
+			, LowerRightCell(InLowerRightCell)
+			, PrimarySort(InPrimarySort)
+			, SecondarySort(InSecondarySort)
+			, UserIndex(InUserIndex)
+			// HankShu-inkiu0@gmail.com add ClickClip Start
+			, ClickClipBlockIndex(INDEX_NONE)
+			// HankShu-inkiu0@gmail.com add ClickClip end
+			, bInRootCell(false)
+			, AncestorChainOffset(FVector2D::ZeroVector)
+			, bSupportsKeyboardFocus(false)
+		{}
+		TWeakPtr<SWidget> WeakWidget;
+		TWeakPtr<ICustomHitTestPath> CustomPath;
+		FIntPoint UpperLeftCell;
+		FIntPoint LowerRightCell;
+		int64 PrimarySort;
+		int32 SecondarySort;
+		int32 UserIndex;
+		// HankShu-inkiu0@gmail.com add ClickClip Start
+		/** Index of the widget's block in ClickClipBlocks, INDEX_NONE for the widgets without ClickClip */
+		int32 ClickClipBlockIndex;
+		// HankShu-inkiu0@gmail.com add ClickClip end
+		/** Grid space bounds when the widget was last added */
+		FSlateRect BoundingRect;
+		/** The widget covers enough cells to live in the RootCell instead of in each of them */
+		bool bInRootCell;
+		/** The paint parents from the window down to the widget, built when the widget is hit and dropped when it is added again */
+		mutable TArray<FAncestorEntry> AncestorChain;
+		/** Desktop space offset the chain geometries were built with */
+		mutable FVector2D AncestorChainOffset;
+		/** The widget is in the NavigationEdges */
+		bool bSupportsKeyboardFocus;
+
+		TSharedPtr<SWidget> GetWidget() const { return WeakWidget.Pin(); }
+	};
+
+	struct FWidgetIndex
+	{
+		FWidgetIndex()
+			: Grid(nullptr)
+			, WidgetIndex(INDEX_NONE)
+		{}
+		FWidgetIndex(const FHittestGrid* InHittestGrid, int32 InIndex)
+			: Grid(InHittestGrid)
+			, WidgetIndex(InIndex)
+		{}
+		bool IsValid() const { return Grid != nullptr && Grid->WidgetArray.IsValidIndex(WidgetIndex); }
+		const FWidgetData& GetWidgetData() const;
+		const FSlateRect& GetCullingRect() const { return Grid->CullingRect; }
+		const FHittestGrid* GetGrid() const { return Grid; }
+
+	private:
+		const FHittestGrid* Grid;
+		int32 WidgetIndex;
+	};
+
+	struct FIndexAndDistance : FWidgetIndex
+	{
+		FIndexAndDistance()
+			: FWidgetIndex()
+			, DistanceSqToWidget(0)
+		{}
+		FIndexAndDistance(FWidgetIndex WidgetIndex, float InDistanceSq)
+			: FWidgetIndex(WidgetIndex)
+			, DistanceSqToWidget(InDistanceSq)
+		{}
+		float GetDistanceSqToWidget() const { return DistanceSqToWidget; }
+
+	private:
+		float DistanceSqToWidget;
+	};
+
+	struct FGridTestingParams;
+
+	/**
+	 * All the available space is partitioned into Cells.
+	 * Each Cell contains a list of widgets that overlap the cell.
+	 * The list is ordered from back to front.
+	 */
+	struct FCell
+	{
+	public:
+		FCell() = default;
+
+		void AddIndex(int32 WidgetIndex);
+		void RemoveIndex(int32 WidgetIndex);
+
+		/** The sort keys of one of the cell's widgets changed, the sorted lists built from it are stale */
+		void MarkSortDirty();
+
+		const TArray<int32>& GetWidgetIndexes() const { return WidgetIndexes; }
+
+		/** Changes every time the cell's widgets or their order change, unique across grids */
+		uint32 GetVersion() const { return Version; }
+		
+	private:
+		TArray<int32> WidgetIndexes;
+		uint32 Version = 0;
+	};
+
+	/** The sorted list of the widgets of a cell of this grid and of its appended grids */
+	struct FCollapsedCell
+	{
+		struct FGridVersion
+		{
+			const FHittestGrid* Grid;
+			uint32 CellVersion;
+			uint32 RootCellVersion;
+		};
+		/** Collapsed grids and their cell versions when the list was built */
+		TArray<FGridVersion, TInlineAllocator<4>> GridVersions;
+		TArray<FWidgetIndex> WidgetIndexes;
+		/** Changes every time WidgetIndexes is rebuilt */
+		uint32 BuildVersion = 0;
+
+		/** Grid space bounds of WidgetIndexes as MinX, MinY, MaxX, MaxY arrays, padded to a multiple of 4 with empty bounds */
+		TArray<float, TAlignedHeapAllocator<16>> Bounds[4];
+		/** HittestGeneration the bounds were copied at */
+		uint32 BoundsGeneration = 0;
+	};
+
+	struct FAppendedGridData
+	{
+		FAppendedGridData(const SWidget* InCachedOwner, const TWeakPtr<const FHittestGrid>& InGrid)
+			 : CachedOwner(InCachedOwner), Grid(InGrid)
+		{ }
+		const SWidget* CachedOwner; // Cached owner of the grid
+		TWeakPtr<const FHittestGrid> Grid;
+	};
+
+	//~ Helper functions
+	bool IsValidCellCoord(const FIntPoint& CellCoord) const;
+	bool IsValidCellCoord(const int32 XCoord, const int32 YCoord) const;
+	void ClearInternal(int32 TotalCells);
+
+	/** Return the Index and distance to a hit given the testing params */
+	FIndexAndDistance GetHitIndexFromCellIndex(const FGridTestingParams& Params) const;
+
+	using FCollapsedWidgetsArray = TArray<FWidgetIndex>;
+	/** Return the Index and distance to a hit among the sorted widgets of the tested cell, the widgets outside of the cursor are rejected 4 at a time from their bounds */
+	FIndexAndDistance GetHitIndexFromCandidates(const FGridTestingParams& Params, const FCollapsedCell& CollapsedCell, int32 FirstCandidate, int32 LastCandidate, int32* OutCandidatePosition = nullptr) const;
+
+	template<typename AllocatorType>
+	void GetBubblePathInternal(FVector2D DesktopSpaceCoordinate, bool bIgnoreEnabledStatus, int32 UserIndex, TArray<FWidgetAndPointer, AllocatorType>& OutPath);
+
+	/** No widget of the cached hover path got disabled since it was built */
+	bool IsHoverPathEnabled(bool bIgnoreEnabledStatus) const;
+
+	struct FBubblePathCache;
+	/** Walk the paint parents of the hit widget into its AncestorChain, PathCache shares the parent walks of a batch. */
+	void BuildAncestorChain(const FWidgetData& WidgetData, const TSharedPtr<SWidget>& FirstHitWidget, FBubblePathCache* PathCache) const;
+
+	/**
+	 * Build the bubble path from the window to the hit widget out of its AncestorChain.
+	 * @return false if there is no path to the hit widget.
+	 */
+	template<typename AllocatorType>
+	bool MakeBubblePath(const FIndexAndDistance& BestHit, FVector2D DesktopSpaceCoordinate, bool bIgnoreEnabledStatus, int32 UserIndex, FBubblePathCache* PathCache, TArray<FWidgetAndPointer, AllocatorType>& OutPath) const;
+
+	/** @returns true if the child is a paint descendant of the provided Parent. */
+	bool IsDescendantOf(const TSharedRef<SWidget> Parent, const FWidgetData& ChildData) const;
+
+	/** A focusable widget and the edge of its bounds a directional navigation reaches first */
+	struct FNavigationEdge
+	{
+		float Edge;
+		int32 WidgetIndex;
+	};
+
+	/** Sort the focusable widgets again if one was added, moved or removed since the last navigation. */
+	void UpdateNavigationEdges() const;
+
+	/** Utility function for searching for the next focusable widget. */
+	template<typename TCompareFunc, typename TSourceSideFunc, typename TDestSideFunc>
+	TSharedPtr<SWidget> FindFocusableWidget(const FSlateRect WidgetRect, const FSlateRect SweptRect, int32 AxisIndex, int32 Increment, const EUINavigation Direction, const FNavigationReply& NavigationReply, TCompareFunc CompareFunc, TSourceSideFunc SourceSideFunc, TDestSideFunc DestSideFunc, int32 UserIndex, TArray<FDebuggingFindNextFocusableWidgetArgs::FWidgetResult>* IntermediatedResultPtr) const;
+
+	/** Constrains a float position into the grid coordinate. */
+	FIntPoint GetCellCoordinate(FVector2D Position) const;
+
+	/** Does a widget covering those cells belong in the RootCell. */
+	bool IsRootCellSpan(const FIntPoint& UpperLeftCell, const FIntPoint& LowerRightCell) const;
+
+	/** Insert the widget index in the cells covered by WidgetData, or in the RootCell. */
+	void AddWidgetToCells(int32 WidgetIndex, const FWidgetData& WidgetData);
+
+	/** Remove the widget index from the cells covered by WidgetData, or from the RootCell. */
+	void RemoveWidgetFromCells(int32 WidgetIndex, const FWidgetData& WidgetData);
+
+	/** Move a widget already in the grid to its new cells, only touching the cells it left or entered. */
+	void UpdateWidgetCells(int32 WidgetIndex, FWidgetData& WidgetData, bool bInRootCell, const FIntPoint& UpperLeftCell, const FIntPoint& LowerRightCell);
+
+	/** Access a cell at coordinates X, Y. Coordinates are row and column indexes. */
+	FORCEINLINE_DEBUGGABLE FCell& CellAt(const int32 X, const int32 Y)
+	{
+		checkfSlow((Y*NumCells.X + X) < Cells.Num(), TEXT("HitTestGrid CellAt() failed: X= %d Y= %d NumCells.X= %d NumCells.Y= %d Cells.Num()= %d"), X, Y, NumCells.X, NumCells.Y, Cells.Num());
+		return Cells[Y*NumCells.X + X];
+	}
+
+	/** Access a cell at coordinates X, Y. Coordinates are row and column indexes. */
+	FORCEINLINE_DEBUGGABLE const FCell& CellAt( const int32 X, const int32 Y ) const
+	{
+		checkfSlow((Y*NumCells.X + X) < Cells.Num(), TEXT("HitTestGrid CellAt() failed: X= %d Y= %d NumCells.X= %d NumCells.Y= %d Cells.Num()= %d"), X, Y, NumCells.X, NumCells.Y, Cells.Num());
+		return Cells[Y*NumCells.X + X];
+	}
+
+	// HankShu-inkiu0@gmail.com add ClickClip Start
+	/** ClickClips of one widget, few enough to live inline */
+	using FClickClipBlock = TArray<TSharedPtr<FSlateClickClippingState>, TInlineAllocator<4>>;
+
+	/** Block index slot of a widget in the grid, null if it isn't in the grid */
+	int32* FindClickClipBlockIndex(const SWidget* InWidget);
+
+	/** Free the block and reset the slot pointing at it */
+	void ReleaseClickClipBlock(int32& InOutBlockIndex);
+
+	/** ClickClip area can be clicked through, only call it for widgets with a block */
+	bool IsThroughClickClip(const FVector2D& WindowSpaceCoordinate, const FWidgetData& ClickWidgetData) const;
+
+	/** ClickClips of the widgets, indexed by FWidgetData::ClickClipBlockIndex */
+	TSparseArray<FClickClipBlock> ClickClipBlocks;
+	// HankShu-inkiu0@gmail.com add ClickClip end
+
+	/** Is the other grid compatible with this grid. */
+	bool CanBeAppended(const FHittestGrid* OtherGrid) const;
+
+	/** Are both grid of the same size. */
+	bool SameSize(const FHittestGrid* OtherGrid) const;
+
+	using FCollapsedHittestGridArray = TArray<const FHittestGrid*, TInlineAllocator<16>>;
+	using FAppendedGridReferenceArray = TArray<TWeakPtr<const FHittestGrid>, TInlineAllocator<16>>;
+	/** Get all the hittest grid appended to this grid. Flattened again only when a grid was appended, removed, resized or destroyed. */
+	const FCollapsedHittestGridArray& GetCollapsedHittestGrid() const;
+
+	/** Recursively collect this grid and the grids appended to it, and references to the appended ones. */
+	void CollectCollapsedHittestGrid(FCollapsedHittestGridArray& OutResult, FAppendedGridReferenceArray& OutAppendedGrids) const;
+
+	/** Return the list of all the widget in that cell, sorted back to front. Rebuilt only when one of the collapsed cells changed. */
+	const FCollapsedCell& GetCollapsedWidgets(const int32 X, const int32 Y) const;
+
+	/** Copy the bounds of the widgets of the sorted list into its bounds arrays. */
+	static void UpdateCollapsedBounds(FCollapsedCell& CollapsedCell);
+
+	/** Mark the cells covered by the widget as needing a new sort */
+	void MarkCellsSortDirty(const FWidgetData& WidgetData);
+
+	/** Remove appended hittest grid that are not valid anymore. */
+	void RemoveStaleAppendedHittestGrid();
+
+private:
+	/** Map of all the widgets currently in the hit test grid to their stable index. */
+	TMap<const SWidget*, int32> WidgetMap;
+
+	/** Stable indexed sparse array of all the widget data we track. */
+	TSparseArray<FWidgetData> WidgetArray;
+
+	/** The cells that make up the space partition. */
+	TArray<FCell> Cells;
+
+	/** The widgets covering most of the grid, a candidate in every cell. */
+	FCell RootCell;
+
+	/** Sorted widget lists of the cells, parallel to Cells. */
+	mutable TArray<FCollapsedCell> CollapsedCells;
+
+	/**
+	 * The last GetBubblePath hit. While no grid changed only the hit widget and the widgets in front of it are tested,
+	 * and the path built for it is returned as long as it stays the front-most hit.
+	 */
+	struct FHoverCache
+	{
+		bool bValid = false;
+		bool bIgnoreEnabledStatus = false;
+		uint32 Generation = 0;
+		/** BuildVersion of the sorted list of the hit cell */
+		uint32 CollapsedVersion = 0;
+		int32 UserIndex = INDEX_NONE;
+		/** Position of the hit widget in the sorted list of the cell */
+		int32 CandidatePosition = INDEX_NONE;
+		/** Bubble path of the hit widget, never extended by a custom path */
+		TArray<FWidgetAndPointer> Path;
+	};
+	FHoverCache HoverCache;
+
+	/** The collapsed grid cached untiled it's dirtied. */
+	TArray<FAppendedGridData> AppendedGridArray;
+
+	/** This grid and all its appended grids, flattened */
+	struct FCollapsedGridsCache
+	{
+		FCollapsedHittestGridArray Grids;
+		/** The appended grids of Grids, one of them being destroyed makes the list stale */
+		FAppendedGridReferenceArray AppendedGrids;
+		/** AppendedGridsGeneration the list was flattened at */
+		uint32 Generation = 0;
+	};
+	mutable FCollapsedGridsCache CollapsedGridsCache;
+
+	/** A grid needs a owner to be appended. */
+	const SWidget* Owner;
+
+	/** Culling Rect used when the widget was painted. */
+	FSlateRect CullingRect;
+
+	/** The size of the grid in cells. */
+	FIntPoint NumCells;
+
+	/** The size of a cell, from Slate.HitTestGrid.CellSize when the grid was last resized. */
+	FVector2D CellSize;
+
+	/** Where the 0,0 of the upper-left-most cell corresponds to in desktop space. */
+	FVector2D GridOrigin;
+
+	/** Where the 0,0 of the upper-left-most cell corresponds to in window space. */
+	FVector2D GridWindowOrigin;
+
+	/** The Size of the current grid. */
+	FVector2D GridSize;
+
+	/** The current slate user index that should be associated with any added widgets */
+	int32 CurrentUserIndex;
+
+	/** Left and Top edges sorted ascending, Right and Bottom edges sorted descending, of the focusable widgets. */
+	mutable TArray<FNavigationEdge> NavigationEdges[4];
+
+	/** NavigationEdges need to be sorted again. */
+	mutable bool bNavigationEdgesDirty;
+};
+
+#if WITH_SLATE_DEBUGGING
+ENUM_CLASS_FLAGS(FHittestGrid::EDisplayGridFlags);
+#endif
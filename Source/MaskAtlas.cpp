@@ -0,0 +1,262 @@
+#include "MaskAtlas.h"
+#include "CanvasTypes.h"
+#include "Containers/Ticker.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+/** Longest side of a tile's image in texels, bigger masks are scaled down */
+static const int32 MAX_MASK_ATLAS_TILE_SIZE = 1024;
+
+/** Black texels around each image, bilinear filtering of an image edge reads them instead of a neighbour */
+static const int32 MASK_ATLAS_GUTTER = 2;
+
+static const int32 MIN_MASK_ATLAS_SIZE = 512;
+
+static const int32 MAX_MASK_ATLAS_SIZE = 4096;
+
+/** How long a mask drawn from a partially streamed texture keeps its mips forced resident */
+static const float MASK_ATLAS_FORCE_RESIDENT_SECONDS = 30.f;
+
+FMaskAtlas& FMaskAtlas::Get()
+{
+	// Never destroyed, the garbage collector may still reference it while statics are torn down
+	static FMaskAtlas* MaskAtlas = new FMaskAtlas();
+	return *MaskAtlas;
+}
+
+void FMaskAtlas::AddTileRef(UTexture2D* Texture)
+{
+	check(IsInGameThread() && Texture);
+
+	FTile& Tile = Tiles.FindOrAdd(FObjectKey(Texture));
+	if (Tile.RefCount++ == 0)
+	{
+		Tile.Texture = Texture;
+		bHasPendingTiles = true;
+		RequestTick();
+	}
+}
+
+void FMaskAtlas::ReleaseTile(const FObjectKey& Texture)
+{
+	FTile* Tile = Tiles.Find(Texture);
+	if (Tile && --Tile->RefCount <= 0)
+	{
+		Tiles.Remove(Texture);
+	}
+}
+
+FIntPoint FMaskAtlas::GetTileSize(const UTexture2D* Texture)
+{
+	// The size of the top mip, whether it is resident or not
+	const int32 SizeX = FMath::Max(Texture->GetSizeX(), 1);
+	const int32 SizeY = FMath::Max(Texture->GetSizeY(), 1);
+	const float Scale = FMath::Min(1.f, static_cast<float>(MAX_MASK_ATLAS_TILE_SIZE) / FMath::Max(SizeX, SizeY));
+	return FIntPoint(
+		FMath::Max(FMath::RoundToInt(SizeX * Scale), 1) + MASK_ATLAS_GUTTER * 2,
+		FMath::Max(FMath::RoundToInt(SizeY * Scale), 1) + MASK_ATLAS_GUTTER * 2);
+}
+
+bool FMaskAtlas::Allocate(const FIntPoint& Size, FIntRect& OutRect)
+{
+	for (FShelf& Shelf : Shelves)
+	{
+		// Only shelves the tile doesn't waste more than half of
+		if (Size.Y <= Shelf.Height && Size.Y * 2 >= Shelf.Height && Shelf.UsedWidth + Size.X <= AtlasSize)
+		{
+			OutRect = FIntRect(Shelf.UsedWidth, Shelf.Y, Shelf.UsedWidth + Size.X, Shelf.Y + Size.Y);
+			Shelf.UsedWidth += Size.X;
+			return true;
+		}
+	}
+
+	const int32 Top = Shelves.Num() > 0 ? Shelves.Last().Y + Shelves.Last().Height : 0;
+	if (Size.X > AtlasSize || Top + Size.Y > AtlasSize)
+	{
+		return false;
+	}
+
+	Shelves.Add({ Top, Size.Y, Size.X });
+	OutRect = FIntRect(0, Top, Size.X, Top + Size.Y);
+	return true;
+}
+
+void FMaskAtlas::Repack()
+{
+	// Tallest first, the shelves are filled tighter
+	TArray<FTile*> PackedTiles;
+	for (TPair<FObjectKey, FTile>& Pair : Tiles)
+	{
+		FTile& Tile = Pair.Value;
+		Tile.Rect = FIntRect();
+		Tile.DrawnMips = 0;
+		Tile.bNoSpace = false;
+		if (Tile.Texture.IsValid())
+		{
+			PackedTiles.Add(&Tile);
+		}
+	}
+	PackedTiles.Sort([](const FTile& A, const FTile& B) { return GetTileSize(A.Texture.Get()).Y > GetTileSize(B.Texture.Get()).Y; });
+
+	int32 Size = FMath::Max(AtlasSize, MIN_MASK_ATLAS_SIZE);
+	for (;;)
+	{
+		AtlasSize = Size;
+		Shelves.Reset();
+		int32 NumPacked = 0;
+		for (FTile* Tile : PackedTiles)
+		{
+			Tile->Rect = FIntRect();
+			if (Allocate(GetTileSize(Tile->Texture.Get()), Tile->Rect))
+			{
+				NumPacked++;
+			}
+			else
+			{
+				Tile->bNoSpace = true;
+			}
+		}
+
+		if (NumPacked == PackedTiles.Num() || Size >= MAX_MASK_ATLAS_SIZE)
+		{
+			if (NumPacked < PackedTiles.Num())
+			{
+				UE_LOG(LogInit, Error, TEXT("ERROR: FMaskAtlas %d mask images don't fit in %dx%d, they are not drawn"), PackedTiles.Num() - NumPacked, Size, Size);
+			}
+			break;
+		}
+
+		for (FTile* Tile : PackedTiles)
+		{
+			Tile->bNoSpace = false;
+		}
+		Size *= 2;
+	}
+
+	// A new render target, widgets that didn't repaint yet keep sampling the previous one with their previous AtlasUV
+	Atlas = NewObject<UTextureRenderTarget2D>(GetTransientPackage());
+	Atlas->ClearColor = FLinearColor::Black;
+	Atlas->InitCustomFormat(AtlasSize, AtlasSize, PF_B8G8R8A8, true);
+	Atlas->UpdateResourceImmediate(true);
+
+	++Generation;
+	bHasPendingTiles = true;
+}
+
+void FMaskAtlas::Update()
+{
+	check(IsInGameThread());
+
+	if (!bHasPendingTiles)
+	{
+		return;
+	}
+	bHasPendingTiles = false;
+
+	for (TPair<FObjectKey, FTile>& Pair : Tiles)
+	{
+		FTile& Tile = Pair.Value;
+		if (Tile.Rect.IsEmpty() && !Tile.bNoSpace && Tile.Texture.IsValid() && !Allocate(GetTileSize(Tile.Texture.Get()), Tile.Rect))
+		{
+			// Released tiles leave holes, packing again reclaims them
+			Repack();
+			break;
+		}
+	}
+
+	FCanvas* Canvas = nullptr;
+	for (TPair<FObjectKey, FTile>& Pair : Tiles)
+	{
+		FTile& Tile = Pair.Value;
+		UTexture2D* Tex = Tile.Texture.Get();
+		if (Tex == nullptr || Tile.Rect.IsEmpty() || Tile.DrawnMips >= Tex->GetNumMips())
+		{
+			continue;
+		}
+
+		const int32 ResidentMips = Tex->GetNumResidentMips();
+		if (Tex->Resource == nullptr || ResidentMips <= Tile.DrawnMips)
+		{
+			// Not loaded yet or no new mips, tried again on the next tick
+			bHasPendingTiles = true;
+			continue;
+		}
+
+		if (Canvas == nullptr)
+		{
+			Canvas = new FCanvas(Atlas->GameThread_GetRenderTargetResource(), nullptr, nullptr, GMaxRHIFeatureLevel);
+		}
+
+		const FIntRect& Rect = Tile.Rect;
+		Canvas->DrawTile(Rect.Min.X + MASK_ATLAS_GUTTER, Rect.Min.Y + MASK_ATLAS_GUTTER,
+			Rect.Width() - MASK_ATLAS_GUTTER * 2, Rect.Height() - MASK_ATLAS_GUTTER * 2,
+			0.f, 0.f, 1.f, 1.f, FLinearColor::White, Tex->Resource, false);
+		Tile.DrawnMips = ResidentMips;
+
+		if (ResidentMips < Tex->GetNumMips())
+		{
+			// Drawn blurry for now, ask for the full resolution and draw it again once it is in
+			Tex->SetForceMipLevelsToBeResident(MASK_ATLAS_FORCE_RESIDENT_SECONDS);
+			bHasPendingTiles = true;
+		}
+	}
+
+	if (Canvas)
+	{
+		Canvas->Flush_GameThread(true);
+		delete Canvas;
+	}
+
+	if (bHasPendingTiles)
+	{
+		RequestTick();
+	}
+}
+
+bool FMaskAtlas::GetTileRect(const UTexture2D* Texture, FLinearColor& OutRect) const
+{
+	const FTile* Tile = Tiles.Find(FObjectKey(Texture));
+	if (Tile == nullptr || Tile->DrawnMips == 0)
+	{
+		return false;
+	}
+
+	// The image inside the gutter
+	const float InvSize = 1.f / AtlasSize;
+	OutRect = FLinearColor(
+		(Tile->Rect.Min.X + MASK_ATLAS_GUTTER) * InvSize,
+		(Tile->Rect.Min.Y + MASK_ATLAS_GUTTER) * InvSize,
+		(Tile->Rect.Width() - MASK_ATLAS_GUTTER * 2) * InvSize,
+		(Tile->Rect.Height() - MASK_ATLAS_GUTTER * 2) * InvSize);
+	return true;
+}
+
+bool FMaskAtlas::IsTilePending(const UTexture2D* Texture) const
+{
+	const FTile* Tile = Tiles.Find(FObjectKey(Texture));
+	return Tile && Tile->DrawnMips == 0 && !Tile->bNoSpace;
+}
+
+bool FMaskAtlas::Tick(float DeltaTime)
+{
+	Update();
+	if (!bHasPendingTiles)
+	{
+		TickHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void FMaskAtlas::RequestTick()
+{
+	if (!TickHandle.IsValid())
+	{
+		TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMaskAtlas::Tick));
+	}
+}
+
+void FMaskAtlas::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(Atlas);
+}
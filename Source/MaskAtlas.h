@@ -0,0 +1,122 @@
+// MIT License
+
+// Copyright (c) 2021 HankShu inkiu0@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "UObject/ObjectKey.h"
+
+class UTexture2D;
+class UTextureRenderTarget2D;
+
+/**
+ * Mask images of every widget drawing its clips from ClipData, one tile per texture shared by all the clips using it.
+ * A tile keeps the resolution of its texture up to MAX_MASK_ATLAS_TILE_SIZE and has a black gutter so bilinear filtering
+ * never reads a neighbour. Tiles are shelf packed, a full atlas is repacked and grown if needed, which moves every tile
+ * (see GetGeneration). The render target is only created with the first tile.
+ */
+class MMOGAME_API FMaskAtlas : public FGCObject
+{
+public:
+
+	static FMaskAtlas& Get();
+
+	/** Reference the tile of Texture, it is drawn by the next Update */
+	void AddTileRef(UTexture2D* Texture);
+
+	/** Release a reference from AddTileRef, the tile's space is reclaimed by the next repack */
+	void ReleaseTile(const FObjectKey& Texture);
+
+	/** Draw the new tiles, and redraw the ones drawn before their texture was fully streamed in */
+	void Update();
+
+	/** (offset.xy, scale.xy) of the image of Texture in the atlas. False while its tile isn't drawn. */
+	bool GetTileRect(const UTexture2D* Texture, FLinearColor& OutRect) const;
+
+	/** The tile of Texture waits for its texture's resource, GetTileRect fails until it is drawn */
+	bool IsTilePending(const UTexture2D* Texture) const;
+
+	/** Null until a tile is referenced */
+	UTextureRenderTarget2D* GetTexture() const { return Atlas; }
+
+	/** Bumped when the tiles are repacked into a new render target, every tile rect may have changed */
+	uint32 GetGeneration() const { return Generation; }
+
+	//~ FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FMaskAtlas"); }
+
+private:
+
+	struct FTile
+	{
+		TWeakObjectPtr<UTexture2D> Texture;
+
+		/** Texels of the tile, gutter included. Empty until it has space. */
+		FIntRect Rect;
+
+		int32 RefCount = 0;
+
+		/** Resident mips the image was drawn from, zero while it isn't drawn */
+		int32 DrawnMips = 0;
+
+		/** Didn't fit in the largest atlas, not drawn until the next repack */
+		bool bNoSpace = false;
+	};
+
+	/** Texels of the tile of Texture, gutter included */
+	static FIntPoint GetTileSize(const UTexture2D* Texture);
+
+	/** Place a tile in the shelves of the current atlas */
+	bool Allocate(const FIntPoint& Size, FIntRect& OutRect);
+
+	/** Pack every referenced tile from scratch, growing the atlas until they fit. Every tile is drawn again. */
+	void Repack();
+
+	/** Draws the tiles still waiting for a texture resource or for more mips, until none is left */
+	bool Tick(float DeltaTime);
+
+	void RequestTick();
+
+	UTextureRenderTarget2D* Atlas = nullptr;
+
+	/** Side of the square atlas in texels */
+	int32 AtlasSize = 0;
+
+	uint32 Generation = 0;
+
+	TMap<FObjectKey, FTile> Tiles;
+
+	/** A row of tiles, Y and Height in texels */
+	struct FShelf
+	{
+		int32 Y;
+		int32 Height;
+		int32 UsedWidth;
+	};
+	TArray<FShelf> Shelves;
+
+	/** Some tile has no space yet, isn't drawn, or is drawn from a partially streamed texture */
+	bool bHasPendingTiles = false;
+
+	FDelegateHandle TickHandle;
+};
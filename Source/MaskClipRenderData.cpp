@@ -0,0 +1,189 @@
+#include "MaskClipRenderData.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "MaskAtlas.h"
+#include "MaskMaterialParameters.h"
+
+/** Smallest ClipData, avoids recreating the textures for the first few clips */
+static const int32 MIN_CLIP_CAPACITY = 4;
+
+/** Rows of ClipData, see FMaskClipRenderData */
+static const int32 CLIP_DATA_ROWS = 4 + MAX_MASK_CLIP_POLYGON_POINTS / 2;
+
+void FMaskClipRenderData::Update(FMaskMaterialParameters& Parameters, TArrayView<const FMaskClipPaintData> Clips, const FVector2D& GeometrySize)
+{
+	const int32 ClipCount = FMath::Min<int32>(Clips.Num(), MAX_MASK_CLIP_COUNT);
+	const bool bRecreated = EnsureCapacity(ClipCount);
+
+	FMaskAtlas& Atlas = FMaskAtlas::Get();
+	UpdateAtlasRefs(Clips, ClipCount);
+	Atlas.Update();
+
+	// Repacking moved every tile
+	const bool bAtlasMoved = AtlasGeneration != Atlas.GetGeneration();
+	AtlasGeneration = Atlas.GetGeneration();
+
+	// Only the columns of changed clips are uploaded, all of them after the textures were recreated.
+	int32 FirstChanged = ClipCapacity;
+	int32 LastChanged = INDEX_NONE;
+	for (int32 i = 0; i < ClipCapacity; i++)
+	{
+		const bool bChanged = i < ClipCount
+			? Clips[i].IsDirty(EMaskClipDirty::Geometry | EMaskClipDirty::Texture | EMaskClipDirty::Shape) || (bAtlasMoved && Clips[i].Texture)
+			: i < UploadedClipCount;
+		if (!bRecreated && !bChanged)
+		{
+			continue;
+		}
+
+		FLinearColor& MaskUV = ClipData[i];
+		FLinearColor& AtlasUV = ClipData[ClipCapacity + i];
+		FLinearColor& Shape = ClipData[ClipCapacity * 2 + i];
+		FLinearColor& ClipSize = ClipData[ClipCapacity * 3 + i];
+		if (i < ClipCount && !Clips[i].bPending)
+		{
+			const FMaskClipPaintData& Clip = Clips[i];
+			const FVector2D Pos = Clip.Position;
+			const FVector2D Size = Clip.Size;
+			MaskUV = FLinearColor(Pos.X / GeometrySize.X, Pos.Y / GeometrySize.Y, Size.X / GeometrySize.X, Size.Y / GeometrySize.Y);
+			// A tile that couldn't be drawn yet is left out rather than sampled empty or stale
+			if (Clip.Texture == nullptr || !Atlas.GetTileRect(Clip.Texture, AtlasUV))
+			{
+				AtlasUV = FLinearColor(0.f, 0.f, 0.f, 0.f);
+			}
+			Shape = FLinearColor(static_cast<float>(Clip.ShapeType), Clip.NumPoints, Clip.CornerRadius, Clip.Feather);
+			ClipSize = FLinearColor(Size.X, Size.Y, 0.f, 0.f);
+			for (int32 PointIndex = 0; PointIndex < MAX_MASK_CLIP_POLYGON_POINTS; PointIndex += 2)
+			{
+				// The material only reads the first NumPoints
+				const FVector2D Point = PointIndex < Clip.NumPoints ? Clip.Points[PointIndex] : FVector2D::ZeroVector;
+				const FVector2D NextPoint = PointIndex + 1 < Clip.NumPoints ? Clip.Points[PointIndex + 1] : FVector2D::ZeroVector;
+				ClipData[ClipCapacity * (4 + PointIndex / 2) + i] = FLinearColor(Point.X, Point.Y, NextPoint.X, NextPoint.Y);
+			}
+		}
+		else
+		{
+			// Removed clips, and clips whose texture is still streaming, cut nothing
+			for (int32 Row = 0; Row < CLIP_DATA_ROWS; Row++)
+			{
+				ClipData[ClipCapacity * Row + i] = FLinearColor(0.f, 0.f, 0.f, 0.f);
+			}
+		}
+		FirstChanged = FMath::Min(FirstChanged, i);
+		LastChanged = i;
+	}
+
+	if (LastChanged >= FirstChanged)
+	{
+		UploadClipData(FirstChanged, LastChanged - FirstChanged + 1);
+	}
+
+	const bool bRebound = bRecreated || BoundMaterial.Get() != Parameters.GetMaterial();
+	if (bRebound)
+	{
+		Parameters.SetClipData(ClipDataTexture);
+		Parameters.SetClipCapacity(ClipCapacity);
+		BoundMaterial = Parameters.GetMaterial();
+	}
+	if (bRebound || BoundAtlas.Get() != Atlas.GetTexture())
+	{
+		// Null until some widget has a textured clip
+		Parameters.SetMaskAtlas(Atlas.GetTexture());
+		BoundAtlas = Atlas.GetTexture();
+	}
+	if (bRebound || UploadedClipCount != ClipCount)
+	{
+		Parameters.SetClipCount(ClipCount);
+	}
+	UploadedClipCount = ClipCount;
+}
+
+bool FMaskClipRenderData::EnsureCapacity(int32 ClipCount)
+{
+	if (ClipDataTexture && ClipCount <= ClipCapacity)
+	{
+		return false;
+	}
+
+	ClipCapacity = FMath::Max<int32>(FMath::RoundUpToPowerOfTwo(ClipCount), MIN_CLIP_CAPACITY);
+	ClipData.SetNumZeroed(ClipCapacity * CLIP_DATA_ROWS);
+
+	ClipDataTexture = UTexture2D::CreateTransient(ClipCapacity, CLIP_DATA_ROWS, PF_A32B32G32R32F);
+	ClipDataTexture->Filter = TF_Nearest;
+	ClipDataTexture->SRGB = false;
+	ClipDataTexture->CompressionSettings = TC_HDR;
+	ClipDataTexture->UpdateResource();
+	return true;
+}
+
+void FMaskClipRenderData::UpdateAtlasRefs(TArrayView<const FMaskClipPaintData> Clips, int32 ClipCount)
+{
+	FMaskAtlas& Atlas = FMaskAtlas::Get();
+
+	// Clips past ClipCount aren't drawn and hold no tile
+	for (int32 i = ClipCount; i < ClipTextures.Num(); i++)
+	{
+		if (ClipTextures[i] != FObjectKey())
+		{
+			Atlas.ReleaseTile(ClipTextures[i]);
+		}
+	}
+	ClipTextures.SetNum(ClipCount);
+
+	for (int32 i = 0; i < ClipCount; i++)
+	{
+		UTexture2D* Tex = Clips[i].Texture;
+		const FObjectKey Key = Tex ? FObjectKey(Tex) : FObjectKey();
+		if (ClipTextures[i] != Key)
+		{
+			if (ClipTextures[i] != FObjectKey())
+			{
+				Atlas.ReleaseTile(ClipTextures[i]);
+			}
+			if (Tex)
+			{
+				Atlas.AddTileRef(Tex);
+			}
+			ClipTextures[i] = Key;
+		}
+	}
+}
+
+void FMaskClipRenderData::UploadClipData(int32 FirstClip, int32 NumClips)
+{
+	const uint32 Pitch = ClipCapacity * sizeof(FLinearColor);
+
+	// Both buffers are released on the render thread once the copy is done.
+	FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(FirstClip, 0, FirstClip, 0, NumClips, CLIP_DATA_ROWS);
+	uint8* SrcData = static_cast<uint8*>(FMemory::Malloc(ClipData.Num() * sizeof(FLinearColor)));
+	FMemory::Memcpy(SrcData, ClipData.GetData(), ClipData.Num() * sizeof(FLinearColor));
+
+	ClipDataTexture->UpdateTextureRegions(0, 1, Region, Pitch, sizeof(FLinearColor), SrcData,
+		[](uint8* InSrcData, const FUpdateTextureRegion2D* InRegions)
+		{
+			FMemory::Free(InSrcData);
+			delete InRegions;
+		});
+}
+
+bool FMaskClipRenderData::IsAtlasTilePending(int32 ClipIndex, const UTexture2D* Texture) const
+{
+	return Texture && ClipTextures.IsValidIndex(ClipIndex) && FMaskAtlas::Get().IsTilePending(Texture);
+}
+
+FMaskClipRenderData::~FMaskClipRenderData()
+{
+	FMaskAtlas& Atlas = FMaskAtlas::Get();
+	for (const FObjectKey& Key : ClipTextures)
+	{
+		if (Key != FObjectKey())
+		{
+			Atlas.ReleaseTile(Key);
+		}
+	}
+}
+
+void FMaskClipRenderData::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(ClipDataTexture);
+}
@@ -0,0 +1,101 @@
+// MIT License
+
+// Copyright (c) 2021 HankShu inkiu0@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "UObject/ObjectKey.h"
+#include "MaskSlateStyle.h"
+
+class UTexture2D;
+class UTextureRenderTarget2D;
+class UMaterialInstanceDynamic;
+class FMaskMaterialParameters;
+
+/**
+ * Clip pipeline of mask materials exposing ClipData / MaskAtlas / ClipCount, any number of clips in one draw.
+ *
+ * ClipData is a float texture of ClipCapacity x 8 texels, column i belongs to clip i:
+ *   row 0    MaskUV    (pos.xy, size.xy) normalized to the widget
+ *   row 1    AtlasUV   (offset.xy, scale.xy) of the clip's mask image in MaskAtlas, zero scale when the clip has no image
+ *   row 2    Shape     (EMaskClipShapeType, polygon point count, corner radius, feather), lengths in slate units
+ *   row 3    ClipSize  (size.xy, 0, 0) in slate units, the shape is evaluated in them so corners stay round
+ *   row 4-7  Points    (point 2n.xy, point 2n+1.xy) of the polygon normalized to the clip
+ * The material evaluates the shapes like FMaskClipShape::IsInside, the edge being the middle of the feather.
+ * MaskAtlas is the FMaskAtlas shared by every widget, mask images are drawn into it on the GPU so compressed textures work.
+ */
+class MMOGAME_API FMaskClipRenderData : public FGCObject
+{
+public:
+
+	/**
+	 * Write the clips to ClipData and MaskAtlas and bind both to the material, see FMaskMaterialParameters::SupportsClipData.
+	 * Only clips flagged dirty are written, the caller clears the flags but keeps Texture on clips with IsAtlasTilePending.
+	 */
+	void Update(FMaskMaterialParameters& Parameters, TArrayView<const FMaskClipPaintData> Clips, const FVector2D& GeometrySize);
+
+	virtual ~FMaskClipRenderData();
+
+	/** The clip's mask image isn't in the atlas yet, its resource wasn't ready. Update writes its AtlasUV once it is. */
+	bool IsAtlasTilePending(int32 ClipIndex, const UTexture2D* Texture) const;
+
+	/** Clips ClipData has room for, the material draws no clip past it */
+	int32 GetClipCapacity() const { return ClipCapacity; }
+
+	//~ FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FMaskClipRenderData"); }
+
+private:
+
+	/** Recreate ClipData when the clip count outgrows it. Returns true when recreated. */
+	bool EnsureCapacity(int32 ClipCount);
+
+	/** Reference the atlas tile of each clip's mask image, releasing the images clips no longer use. */
+	void UpdateAtlasRefs(TArrayView<const FMaskClipPaintData> Clips, int32 ClipCount);
+
+	/** Upload NumClips columns of ClipData to the texture. */
+	void UploadClipData(int32 FirstClip, int32 NumClips);
+
+	UTexture2D* ClipDataTexture = nullptr;
+
+	/** CPU copy of ClipDataTexture, ClipCapacity x CLIP_DATA_ROWS */
+	TArray<FLinearColor> ClipData;
+
+	/** Mask image each clip references in FMaskAtlas */
+	TArray<FObjectKey> ClipTextures;
+
+	/** Material ClipData and MaskAtlas are bound to */
+	TWeakObjectPtr<UMaterialInstanceDynamic> BoundMaterial;
+
+	/** Atlas bound to BoundMaterial */
+	TWeakObjectPtr<UTextureRenderTarget2D> BoundAtlas;
+
+	/** FMaskAtlas::GetGeneration the AtlasUV were written at */
+	uint32 AtlasGeneration = 0;
+
+	int32 ClipCapacity = 0;
+
+	/** Clips written by the last update */
+	int32 UploadedClipCount = 0;
+};
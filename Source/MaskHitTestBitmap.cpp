@@ -0,0 +1,160 @@
+#include "MaskHitTestBitmap.h"
+#include "Engine/Texture2D.h"
+#include "MaskHitTestUserData.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace MaskHitTestBitmap
+{
+	/** Bitmaps shared by every clip using the same texture. */
+	static TMap<FObjectKey, TSharedPtr<const FMaskHitTestBitmap>> Cache;
+
+	static FDelegateHandle PostGarbageCollectHandle;
+}
+
+FMaskHitTestBitmap::FMaskHitTestBitmap(const UTexture2D* Texture, int32 InSizeX, int32 InSizeY)
+	: SourceTexture(Texture)
+	, SizeX(InSizeX)
+	, SizeY(InSizeY)
+{
+	Bits.SetNumZeroed(FMath::DivideAndRoundUp(SizeX * SizeY, 32));
+}
+
+TSharedPtr<const FMaskHitTestBitmap> FMaskHitTestBitmap::FindOrBuild(const UTexture2D* Texture)
+{
+	check(IsInGameThread());
+
+	if (Texture == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (!MaskHitTestBitmap::PostGarbageCollectHandle.IsValid())
+	{
+		MaskHitTestBitmap::PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&FMaskHitTestBitmap::PurgeStaleBitmaps);
+	}
+
+	const FObjectKey Key(Texture);
+	if (const TSharedPtr<const FMaskHitTestBitmap>* Found = MaskHitTestBitmap::Cache.Find(Key))
+	{
+		// Unreadable textures are cached as null so they are reported once.
+		return *Found;
+	}
+
+	TSharedPtr<const FMaskHitTestBitmap> Bitmap = BuildFromSidecar(Texture);
+	if (!Bitmap.IsValid())
+	{
+		Bitmap = BuildFromPlatformData(Texture);
+	}
+	if (!Bitmap.IsValid())
+	{
+		UE_LOG(LogInit, Warning, TEXT("FMaskHitTestBitmap: %s has no hit-test sidecar and can't be read back, resave it in the editor or use RGBA32."), *Texture->GetName());
+	}
+	MaskHitTestBitmap::Cache.Add(Key, Bitmap);
+	return Bitmap;
+}
+
+const FMaskHitTestBitmap* FMaskHitTestBitmap::Find(const UTexture2D* Texture)
+{
+	const TSharedPtr<const FMaskHitTestBitmap>* Found = MaskHitTestBitmap::Cache.Find(FObjectKey(Texture));
+	return Found ? Found->Get() : nullptr;
+}
+
+TSharedPtr<FMaskHitTestBitmap> FMaskHitTestBitmap::BuildFromSidecar(const UTexture2D* Texture)
+{
+	// Sidecars are only added when cooking (see UMaskWidget::PreSave), never while building a clip or hit testing
+	const UMaskHitTestUserData* UserData = UMaskHitTestUserData::Find(Texture);
+	if (UserData == nullptr || !UserData->IsValidData())
+	{
+		return nullptr;
+	}
+
+	// The sidecar may be at source resolution, lookups are in UV space so it doesn't have to match the mips.
+	TSharedPtr<FMaskHitTestBitmap> Bitmap = MakeShareable(new FMaskHitTestBitmap(Texture, UserData->SizeX, UserData->SizeY));
+	Bitmap->Bits = UserData->Bits;
+	return Bitmap;
+}
+
+TSharedPtr<FMaskHitTestBitmap> FMaskHitTestBitmap::BuildFromPlatformData(const UTexture2D* Texture)
+{
+	const FTexturePlatformData* PlatformData = Texture->PlatformData;
+	if (PlatformData == nullptr || PlatformData->Mips.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	// Offset of R inside a texel
+	int32 ROffset;
+	switch (PlatformData->PixelFormat)
+	{
+	case PF_B8G8R8A8:
+		ROffset = 2;
+		break;
+	case PF_R8G8B8A8:
+		ROffset = 0;
+		break;
+	default:
+		return nullptr;
+	}
+
+	const FTexture2DMipMap& Mip = PlatformData->Mips[0];
+	const int32 MipSizeX = Mip.SizeX;
+	const int32 MipSizeY = Mip.SizeY;
+	if (MipSizeX <= 0 || MipSizeY <= 0 || Mip.BulkData.GetBulkDataSize() < MipSizeX * MipSizeY * 4)
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FMaskHitTestBitmap> Bitmap = MakeShareable(new FMaskHitTestBitmap(Texture, MipSizeX, MipSizeY));
+
+	// The only lock of the bulk data, done when the texture is assigned to a clip or streamed in.
+	FByteBulkData& BulkData = const_cast<FByteBulkData&>(Mip.BulkData);
+	if (const uint8* MaskData = static_cast<const uint8*>(BulkData.LockReadOnly()))
+	{
+		const int32 TexelCount = MipSizeX * MipSizeY;
+		for (int32 Index = 0; Index < TexelCount; Index++)
+		{
+			if (MaskData[Index * 4 + ROffset] > 0)
+			{
+				Bitmap->SetBit(Index);
+			}
+		}
+		BulkData.Unlock();
+		return Bitmap;
+	}
+
+	BulkData.Unlock();
+	return nullptr;
+}
+
+bool FMaskHitTestBitmap::IsClickThrough(const FVector2D& HitUVInMask) const
+{
+	if (HitUVInMask.X < 0.f || HitUVInMask.X > 1.f || HitUVInMask.Y < 0.f || HitUVInMask.Y > 1.f)
+	{
+		return false;
+	}
+
+	// UV of exactly 1 lands on the last texel
+	const int32 X = FMath::Min(FMath::FloorToInt(HitUVInMask.X * SizeX), SizeX - 1);
+	const int32 Y = FMath::Min(FMath::FloorToInt(HitUVInMask.Y * SizeY), SizeY - 1);
+	return GetBit(Y * SizeX + X);
+}
+
+void FMaskHitTestBitmap::Invalidate(const UTexture2D* Texture)
+{
+	// Clicks only read the cache, a texture in use is rebuilt here rather than on the next click
+	if (MaskHitTestBitmap::Cache.Remove(FObjectKey(Texture)) > 0)
+	{
+		FindOrBuild(Texture);
+	}
+}
+
+void FMaskHitTestBitmap::PurgeStaleBitmaps()
+{
+	for (auto It = MaskHitTestBitmap::Cache.CreateIterator(); It; ++It)
+	{
+		if (It.Key().ResolveObjectPtr() == nullptr)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
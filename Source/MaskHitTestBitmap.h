@@ -0,0 +1,84 @@
+// MIT License
+
+// Copyright (c) 2021 HankShu inkiu0@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UTexture2D;
+
+/**
+ * Click-through bitmap of a mask texture.
+ * The R channel is thresholded once and packed into 32 bit words, so a hit test is a shift and a mask
+ * and never has to lock the texture's bulk data on the input path.
+ */
+class MMOGAME_API FMaskHitTestBitmap
+{
+public:
+
+	/** Returns the cached bitmap of Texture, building it on first use. Null if the texture can't be read. */
+	static TSharedPtr<const FMaskHitTestBitmap> FindOrBuild(const UTexture2D* Texture);
+
+	/** Returns the cached bitmap of Texture, never builds it so it is safe on the input path. Null if not built yet. */
+	static const FMaskHitTestBitmap* Find(const UTexture2D* Texture);
+
+	/** Rebuild the bitmap of Texture if one is cached. Used when the source art changes. */
+	static void Invalidate(const UTexture2D* Texture);
+
+	/** Is the texel under HitUVInMask (0..1 in mask space) click-through */
+	bool IsClickThrough(const FVector2D& HitUVInMask) const;
+
+	/** Was this bitmap built from Texture */
+	bool IsBuiltFrom(const UTexture2D* Texture) const { return SourceTexture == FObjectKey(Texture); }
+
+	int32 GetSizeX() const { return SizeX; }
+
+	int32 GetSizeY() const { return SizeY; }
+
+	uint32 GetAllocatedSize() const { return Bits.GetAllocatedSize(); }
+
+private:
+
+	FMaskHitTestBitmap(const UTexture2D* Texture, int32 InSizeX, int32 InSizeY);
+
+	/** Copy the sidecar built from the source art, works for block-compressed textures. */
+	static TSharedPtr<FMaskHitTestBitmap> BuildFromSidecar(const UTexture2D* Texture);
+
+	/** Threshold the R channel of the first mip, only uncompressed 8 bit RGBA formats can be read back. */
+	static TSharedPtr<FMaskHitTestBitmap> BuildFromPlatformData(const UTexture2D* Texture);
+
+	/** Drop bitmaps whose texture has been garbage collected. */
+	static void PurgeStaleBitmaps();
+
+	FORCEINLINE void SetBit(int32 Index) { Bits[Index >> 5] |= 1u << (Index & 31); }
+
+	FORCEINLINE bool GetBit(int32 Index) const { return (Bits[Index >> 5] >> (Index & 31)) & 1u; }
+
+	FObjectKey SourceTexture;
+
+	int32 SizeX = 0;
+
+	int32 SizeY = 0;
+
+	TArray<uint32> Bits;
+};
@@ -0,0 +1,133 @@
+#include "MaskHitTestUserData.h"
+#include "Engine/Texture2D.h"
+#include "MaskHitTestBitmap.h"
+
+UMaskHitTestUserData::UMaskHitTestUserData(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, SizeX(0)
+	, SizeY(0)
+{
+}
+
+const UMaskHitTestUserData* UMaskHitTestUserData::Find(const UTexture2D* Texture)
+{
+	if (Texture == nullptr)
+	{
+		return nullptr;
+	}
+	return const_cast<UTexture2D*>(Texture)->GetAssetUserData<UMaskHitTestUserData>();
+}
+
+#if WITH_EDITOR
+
+UMaskHitTestUserData* UMaskHitTestUserData::FindOrAdd(UTexture2D* Texture)
+{
+	if (Texture == nullptr || !Texture->Source.IsValid())
+	{
+		return nullptr;
+	}
+
+	UMaskHitTestUserData* UserData = Texture->GetAssetUserData<UMaskHitTestUserData>();
+	if (UserData == nullptr)
+	{
+		Texture->Modify();
+		UserData = NewObject<UMaskHitTestUserData>(Texture, NAME_None, RF_Public | RF_Transactional);
+		Texture->AddAssetUserData(UserData);
+	}
+
+	if (UserData->SourceId != Texture->Source.GetId())
+	{
+		UserData->Modify();
+		UserData->Rebuild();
+	}
+	return UserData;
+}
+
+bool UMaskHitTestUserData::Rebuild()
+{
+	UTexture2D* Texture = GetTypedOuter<UTexture2D>();
+	if (Texture == nullptr || !Texture->Source.IsValid())
+	{
+		return false;
+	}
+
+	const FTextureSource& Source = Texture->Source;
+
+	// Offset of R inside a texel and the texel size, in bytes
+	int32 ROffset = 0;
+	int32 TexelSize = 0;
+	switch (Source.GetFormat())
+	{
+	case TSF_G8:
+		TexelSize = 1;
+		break;
+	case TSF_BGRA8:
+		ROffset = 2;
+		TexelSize = 4;
+		break;
+	case TSF_RGBA16:
+	case TSF_RGBA16F:
+		// R is the first 16 bits, any non zero value of either encoding is above the threshold
+		TexelSize = 8;
+		break;
+	default:
+		UE_LOG(LogInit, Warning, TEXT("UMaskHitTestUserData: unsupported source format of %s, no hit-test sidecar built."), *Texture->GetName());
+		return false;
+	}
+
+	TArray64<uint8> MipData;
+	if (!const_cast<FTextureSource&>(Source).GetMipData(MipData, 0))
+	{
+		return false;
+	}
+
+	const int32 NewSizeX = Source.GetSizeX();
+	const int32 NewSizeY = Source.GetSizeY();
+	const int64 TexelCount = (int64)NewSizeX * NewSizeY;
+	if (MipData.Num() < TexelCount * TexelSize)
+	{
+		return false;
+	}
+
+	SizeX = NewSizeX;
+	SizeY = NewSizeY;
+	Bits.Reset();
+	Bits.SetNumZeroed(FMath::DivideAndRoundUp(SizeX * SizeY, 32));
+
+	for (int32 Index = 0; Index < TexelCount; Index++)
+	{
+		const uint8* Texel = &MipData[Index * TexelSize];
+		const bool bThrough = TexelSize == 8 ? (Texel[0] | Texel[1]) != 0 : Texel[ROffset] > 0;
+		if (bThrough)
+		{
+			Bits[Index >> 5] |= 1u << (Index & 31);
+		}
+	}
+
+	SourceId = Source.GetId();
+	FMaskHitTestBitmap::Invalidate(Texture);
+	return true;
+}
+
+void UMaskHitTestUserData::PostEditChangeOwner()
+{
+	Super::PostEditChangeOwner();
+
+	// Reimported or edited source art
+	Rebuild();
+}
+
+void UMaskHitTestUserData::PreSave(const class ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+	if (const UTexture2D* Texture = GetTypedOuter<UTexture2D>())
+	{
+		if (Texture->Source.IsValid() && SourceId != Texture->Source.GetId())
+		{
+			Rebuild();
+		}
+	}
+}
+
+#endif
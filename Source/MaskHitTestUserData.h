@@ -0,0 +1,76 @@
+// MIT License
+
+// Copyright (c) 2021 HankShu inkiu0@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "MaskHitTestUserData.generated.h"
+
+class UTexture2D;
+
+/**
+ * Hit-test sidecar stored on a mask texture.
+ * Built in the editor from the uncompressed source art, so the rendered mask can use ETC2/ASTC/BC
+ * while click-through stays exact. Same packing as FMaskHitTestBitmap: R channel thresholded, 32 texels per word.
+ */
+UCLASS()
+class MMOGAME_API UMaskHitTestUserData : public UAssetUserData
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	UPROPERTY(VisibleAnywhere, Category = HitTest)
+	int32 SizeX;
+
+	UPROPERTY(VisibleAnywhere, Category = HitTest)
+	int32 SizeY;
+
+	UPROPERTY()
+	TArray<uint32> Bits;
+
+	bool IsValidData() const { return SizeX > 0 && SizeY > 0 && Bits.Num() == FMath::DivideAndRoundUp(SizeX * SizeY, 32); }
+
+	/** Returns the sidecar of Texture, null if it has none */
+	static const UMaskHitTestUserData* Find(const UTexture2D* Texture);
+
+#if WITH_EDITOR
+	/** Returns the sidecar of Texture, adding and building it if missing. Dirties the texture package when added. */
+	static UMaskHitTestUserData* FindOrAdd(UTexture2D* Texture);
+
+	/** Rebuild from the owning texture's source art. */
+	bool Rebuild();
+
+	virtual void PostEditChangeOwner() override;
+
+	virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+#endif
+
+#if WITH_EDITORONLY_DATA
+private:
+
+	/** Id of the source art the bits were built from */
+	UPROPERTY()
+	FGuid SourceId;
+#endif
+};
@@ -0,0 +1,130 @@
+#include "MaskMaterialParameters.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+namespace MaskMaterialParameterNames
+{
+	static FName MakeIndexedName(const TCHAR* Prefix, int32 Index)
+	{
+		return FName(*FString::Printf(TEXT("%s_%d"), Prefix, Index));
+	}
+
+	struct FNames
+	{
+		FName MaskUV[LEGACY_MASK_CLIP_COUNT];
+		FMaterialParameterInfo MaskTex[LEGACY_MASK_CLIP_COUNT];
+		FMaterialParameterInfo BgTex = FMaterialParameterInfo(TEXT("BgTex"));
+		FMaterialParameterInfo ClipData = FMaterialParameterInfo(TEXT("ClipData"));
+		FMaterialParameterInfo MaskAtlas = FMaterialParameterInfo(TEXT("MaskAtlas"));
+		FName ClipCount = TEXT("ClipCount");
+		FName ClipCapacity = TEXT("ClipCapacity");
+
+		FNames()
+		{
+			for (int32 i = 0; i < LEGACY_MASK_CLIP_COUNT; i++)
+			{
+				MaskUV[i] = MakeIndexedName(TEXT("MaskUV"), i);
+				MaskTex[i] = FMaterialParameterInfo(MakeIndexedName(TEXT("MaskTex"), i));
+			}
+		}
+	};
+
+	static const FNames& Get()
+	{
+		static const FNames Names;
+		return Names;
+	}
+}
+
+bool FMaskMaterialParameters::Bind(UMaterialInstanceDynamic* DyMat)
+{
+	if (BoundMaterial.Get() == DyMat)
+	{
+		return false;
+	}
+
+	Reset();
+	BoundMaterial = DyMat;
+
+	UTexture* Unused = nullptr;
+	bSupportsClipData = DyMat && DyMat->GetTextureParameterValue(MaskMaterialParameterNames::Get().ClipData, Unused);
+	return true;
+}
+
+void FMaskMaterialParameters::Reset()
+{
+	BoundMaterial.Reset();
+	for (int32& Index : MaskUVIndices)
+	{
+		Index = INDEX_NONE;
+	}
+	ClipCountIndex = INDEX_NONE;
+	ClipCapacityIndex = INDEX_NONE;
+	bSupportsClipData = false;
+}
+
+void FMaskMaterialParameters::SetMaskUV(int32 ClipIndex, const FLinearColor& Value)
+{
+	check(ClipIndex >= 0 && ClipIndex < LEGACY_MASK_CLIP_COUNT);
+	SetVector(MaskUVIndices[ClipIndex], MaskMaterialParameterNames::Get().MaskUV[ClipIndex], Value);
+}
+
+void FMaskMaterialParameters::SetMaskTex(int32 ClipIndex, UTexture* Value)
+{
+	check(ClipIndex >= 0 && ClipIndex < LEGACY_MASK_CLIP_COUNT);
+	SetTexture(MaskMaterialParameterNames::Get().MaskTex[ClipIndex], Value);
+}
+
+void FMaskMaterialParameters::SetBgTex(UTexture* Value)
+{
+	SetTexture(MaskMaterialParameterNames::Get().BgTex, Value);
+}
+
+void FMaskMaterialParameters::SetClipData(UTexture* Value)
+{
+	SetTexture(MaskMaterialParameterNames::Get().ClipData, Value);
+}
+
+void FMaskMaterialParameters::SetMaskAtlas(UTexture* Value)
+{
+	SetTexture(MaskMaterialParameterNames::Get().MaskAtlas, Value);
+}
+
+void FMaskMaterialParameters::SetClipCount(float Value)
+{
+	SetScalar(ClipCountIndex, MaskMaterialParameterNames::Get().ClipCount, Value);
+}
+
+void FMaskMaterialParameters::SetClipCapacity(float Value)
+{
+	SetScalar(ClipCapacityIndex, MaskMaterialParameterNames::Get().ClipCapacity, Value);
+}
+
+void FMaskMaterialParameters::SetVector(int32& ParameterIndex, const FName& Name, const FLinearColor& Value)
+{
+	if (UMaterialInstanceDynamic* DyMat = BoundMaterial.Get())
+	{
+		if (ParameterIndex == INDEX_NONE || !DyMat->SetVectorParameterByIndex(ParameterIndex, Value))
+		{
+			DyMat->InitializeVectorParameterAndGetIndex(Name, Value, ParameterIndex);
+		}
+	}
+}
+
+void FMaskMaterialParameters::SetScalar(int32& ParameterIndex, const FName& Name, float Value)
+{
+	if (UMaterialInstanceDynamic* DyMat = BoundMaterial.Get())
+	{
+		if (ParameterIndex == INDEX_NONE || !DyMat->SetScalarParameterByIndex(ParameterIndex, Value))
+		{
+			DyMat->InitializeScalarParameterAndGetIndex(Name, Value, ParameterIndex);
+		}
+	}
+}
+
+void FMaskMaterialParameters::SetTexture(const FMaterialParameterInfo& Info, UTexture* Value)
+{
+	if (UMaterialInstanceDynamic* DyMat = BoundMaterial.Get())
+	{
+		DyMat->SetTextureParameterValueByInfo(Info, Value);
+	}
+}
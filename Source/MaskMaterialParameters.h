@@ -0,0 +1,85 @@
+// MIT License
+
+// Copyright (c) 2021 HankShu inkiu0@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaskSlateStyle.h"
+#include "Materials/MaterialLayersFunctions.h"
+
+class UTexture;
+class UMaterialInstanceDynamic;
+
+/**
+ * Parameters of one mask material instance.
+ * Names are built once for all widgets, scalar and vector indices are resolved once per instance
+ * so per-frame updates go through the index based setters instead of hashing names.
+ */
+class MMOGAME_API FMaskMaterialParameters
+{
+public:
+
+	FMaskMaterialParameters() { Reset(); }
+
+	/** Resolve the parameters of DyMat, cheap when already bound to it. Returns true when DyMat is newly bound and has none of our values. */
+	bool Bind(UMaterialInstanceDynamic* DyMat);
+
+	/** Forget the resolved indices, needed after the instance's parameter values are cleared */
+	void Reset();
+
+	UMaterialInstanceDynamic* GetMaterial() const { return BoundMaterial.Get(); }
+
+	/** Does the material draw its clips from ClipData (see FMaskClipRenderData) */
+	bool SupportsClipData() const { return bSupportsClipData; }
+
+	void SetMaskUV(int32 ClipIndex, const FLinearColor& Value);
+
+	void SetMaskTex(int32 ClipIndex, UTexture* Value);
+
+	void SetBgTex(UTexture* Value);
+
+	void SetClipData(UTexture* Value);
+
+	void SetMaskAtlas(UTexture* Value);
+
+	void SetClipCount(float Value);
+
+	void SetClipCapacity(float Value);
+
+private:
+
+	void SetVector(int32& ParameterIndex, const FName& Name, const FLinearColor& Value);
+
+	void SetScalar(int32& ParameterIndex, const FName& Name, float Value);
+
+	void SetTexture(const FMaterialParameterInfo& Info, UTexture* Value);
+
+	TWeakObjectPtr<UMaterialInstanceDynamic> BoundMaterial;
+
+	int32 MaskUVIndices[LEGACY_MASK_CLIP_COUNT];
+
+	int32 ClipCountIndex = INDEX_NONE;
+
+	int32 ClipCapacityIndex = INDEX_NONE;
+
+	bool bSupportsClipData = false;
+};
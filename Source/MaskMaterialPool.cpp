@@ -0,0 +1,86 @@
+#include "MaskMaterialPool.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+namespace MaskMaterialPool
+{
+	static const TSoftObjectPtr<UMaterialInterface> MaskMaterialPath(FSoftObjectPath(TEXT("/Game/Assets/UI/Material/Slate/MaskMaterial.MaskMaterial")));
+}
+
+/** Free instances kept for the next widgets, the rest are left to the garbage collector */
+static const int32 MAX_FREE_INSTANCES = 8;
+
+FMaskMaterialPool& FMaskMaterialPool::Get()
+{
+	// Never destroyed, the garbage collector may still reference it while statics are torn down
+	static FMaskMaterialPool* Pool = new FMaskMaterialPool();
+	return *Pool;
+}
+
+UMaterialInterface* FMaskMaterialPool::GetMaskMaterial()
+{
+	check(IsInGameThread());
+
+	if (!MaskMaterialHandle.IsValid())
+	{
+		// The delegate may run before RequestAsyncLoad returns when the material is already in memory
+		MaskMaterialHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MaskMaterialPool::MaskMaterialPath.ToSoftObjectPath(),
+			FStreamableDelegate::CreateRaw(this, &FMaskMaterialPool::HandleMaskMaterialStreamed));
+	}
+	return MaskMaterial;
+}
+
+void FMaskMaterialPool::HandleMaskMaterialStreamed()
+{
+	MaskMaterial = MaskMaterialPool::MaskMaterialPath.Get();
+	if (MaskMaterial == nullptr)
+	{
+		UE_LOG(LogInit, Error, TEXT("ERROR: FMaskMaterialPool can't load %s"), *MaskMaterialPool::MaskMaterialPath.ToString());
+		return;
+	}
+	MaskMaterialLoaded.Broadcast();
+}
+
+UMaterialInstanceDynamic* FMaskMaterialPool::Acquire()
+{
+	UMaterialInstanceDynamic* DyMat = nullptr;
+	if (FreeInstances.Num() > 0)
+	{
+		DyMat = FreeInstances.Pop(false);
+	}
+	else if (UMaterialInterface* Mat = GetMaskMaterial())
+	{
+		DyMat = UMaterialInstanceDynamic::Create(Mat, GetTransientPackage());
+	}
+
+	if (DyMat)
+	{
+		UsedInstances.Add(DyMat);
+	}
+	return DyMat;
+}
+
+void FMaskMaterialPool::Release(UMaterialInstanceDynamic* DyMat)
+{
+	// Widgets destroyed after the UObject system shut down have nothing to give back
+	if (DyMat == nullptr || !UObjectInitialized() || UsedInstances.RemoveSwap(DyMat, false) == 0)
+	{
+		return;
+	}
+
+	if (FreeInstances.Num() < MAX_FREE_INSTANCES && IsValid(DyMat))
+	{
+		// The next widget binds it from scratch, see FMaskMaterialParameters::Bind
+		DyMat->ClearParameterValues();
+		FreeInstances.Add(DyMat);
+	}
+}
+
+void FMaskMaterialPool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(MaskMaterial);
+	Collector.AddReferencedObjects(UsedInstances);
+	Collector.AddReferencedObjects(FreeInstances);
+}
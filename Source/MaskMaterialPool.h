@@ -0,0 +1,74 @@
+// MIT License
+
+// Copyright (c) 2021 HankShu inkiu0@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+struct FStreamableHandle;
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+
+/**
+ * Dynamic instances of the mask material, handed to SMaskWidget when it first paints and recycled when it is destroyed.
+ * The mask material is streamed in once for all widgets, styles never create instances.
+ */
+class MMOGAME_API FMaskMaterialPool : public FGCObject
+{
+public:
+
+	static FMaskMaterialPool& Get();
+
+	/** The mask material every instance is made from, starts streaming it in. Null until it is loaded or if it can't be. */
+	UMaterialInterface* GetMaskMaterial();
+
+	/** A free instance of the mask material, created when none is free. Null while there is no mask material. */
+	UMaterialInstanceDynamic* Acquire();
+
+	/** Broadcast once the mask material streamed in, widgets that got no instance can acquire one */
+	FSimpleMulticastDelegate& OnMaskMaterialLoaded() { return MaskMaterialLoaded; }
+
+	/** Give back an instance from Acquire, its parameter values are cleared for the next widget */
+	void Release(UMaterialInstanceDynamic* DyMat);
+
+	//~ FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FMaskMaterialPool"); }
+
+private:
+
+	void HandleMaskMaterialStreamed();
+
+	UMaterialInterface* MaskMaterial = nullptr;
+
+	/** Keeps the mask material loaded, valid once requested */
+	TSharedPtr<FStreamableHandle> MaskMaterialHandle;
+
+	FSimpleMulticastDelegate MaskMaterialLoaded;
+
+	/** Instances painted by a widget */
+	TArray<UMaterialInstanceDynamic*> UsedInstances;
+
+	/** Instances released by destroyed widgets, kept up to MAX_FREE_INSTANCES */
+	TArray<UMaterialInstanceDynamic*> FreeInstances;
+};
@@ -1,153 +1,326 @@
-#include "MaskSlateStyle.h"
-#include "Materials/Material.h"
-#include "Materials/MaterialInstanceDynamic.h"
-
-FMaskWidgetStyle::FMaskWidgetStyle()
-: BackgroundImage()
-, MaskMatBrush()
-{
-	static UMaterial* Mat = LoadObject<UMaterial>(NULL, TEXT("/Game/Assets/UI/Material/Slate/MaskMaterial.MaskMaterial"));
-	if (UMaterial* Mat = LoadObject<UMaterial>(NULL, TEXT("/Game/Assets/UI/Material/Slate/MaskMaterial.MaskMaterial")))
-	{
-		if (UMaterialInstanceDynamic* DyMat = UMaterialInstanceDynamic::Create(Mat, GetTransientPackage()))
-		{
-			MaskMatBrush.SetResourceObject(DyMat);
-		}
-		else
-		{
-			MaskMatBrush.SetResourceObject(Mat);
-		}
-	}
-}
-
-void FMaskWidgetStyle::GetResources(TArray< const FSlateBrush* >& OutBrushes) const
-{
-	OutBrushes.Add(&BackgroundImage);
-	OutBrushes.Add(&MaskMatBrush);
-}
-
-const FName FMaskWidgetStyle::TypeName(TEXT("FMaskWidgetStyle"));
-
-const FMaskWidgetStyle& FMaskWidgetStyle::GetDefault()
-{
-	static FMaskWidgetStyle Default;
-	return Default;
-}
-
-void FMaskWidgetStyle::ReIndexClip()
-{
-	for (uint8 i = 0; i < MaskClips.Num(); i++)
-	{
-		MaskClips[i].SetIndex(i);
-	}
-}
-
-const UTexture2D* FMaskWidgetStyle::GetMaskTextureByIdx(const int32& Index) const
-{
-	if (MaskClips.Num() > Index)
-	{
-		return MaskClips[Index].GetMaskTexture();
-	}
-	return nullptr;
-}
-
-bool FMaskWidgetStyle::SetMaskTextureByIdx(const int32& Index, UTexture2D* Texture)
-{
-	if (MaskClips.Num() > Index)
-	{
-		MaskClips[Index].SetMaskTexture(Texture);
-		return true;
-	}
-	return false;
-}
-
-bool FMaskWidgetStyle::SetMaskSize(const int32& Index, const FVector2D& Size)
-{
-	if (MaskClips.Num() > Index)
-	{
-		MaskClips[Index].SetSize(Size);
-		return true;
-	}
-	return false;
-}
-
-bool FMaskWidgetStyle::SetMaskSizeXY(const int32& Index, const float& X, const float& Y)
-{
-	if (MaskClips.Num() > Index)
-	{
-		return true;
-	}
-	return false;
-}
-
-bool FMaskWidgetStyle::SetMaskPos(const int32& Index, const FVector2D& Pos)
-{
-	if (MaskClips.Num() > Index)
-	{
-		MaskClips[Index].SetPosition(Pos);
-		return true;
-	}
-	return false;
-}
-
-bool FMaskWidgetStyle::SetMaskPosXY(const int32& Index, const float& X, const float& Y)
-{
-	if (MaskClips.Num() > Index)
-	{
-		return true;
-	}
-	return false;
-}
-
-bool FMaskWidgetStyle::SetMaskPosSize(const int32& Index, const FVector4& PosSize)
-{
-	if (MaskClips.Num() > Index)
-	{
-		return true;
-	}
-	return false;
-}
-
-bool FMaskWidgetStyle::SetMaskPosSizeXYZW(const int32& Index, const float& X, const float& Y, const float& Z, const float& W)
-{
-	if (MaskClips.Num() > Index)
-	{
-		return true;
-	}
-	return false;
-}
-
-bool FMaskWidgetStyle::EnableMaskClickClip(const int32& Index, bool Enable)
-{
-	if (MaskClips.Num() > Index)
-	{
-		MaskClips[Index].SetEnable(Enable);
-		return true;
-	}
-	return false;
-}
-
-int32 FMaskWidgetStyle::AddMaskClickClip(const FVector2D& Position, const FVector2D& Size, UTexture2D* Mask)
-{
-	int32 Count = MaskClips.Num();
-	if (Count < MAX_MASK_CLIP_COUNT)
-	{
-		MaskClips.Add(FMaskClip(Count, Position, Size, Mask));
-		return Count;
-	}
-	return -1;
-}
-
-bool FMaskWidgetStyle::RemoveMaskClickClip(const int32& ClipIndex)
-{
-	if (ClipIndex >= 0 && ClipIndex < MaskClips.Num())
-	{
-		MaskClips.RemoveAt(ClipIndex);
-		return true;
-	}
-	else
-	{
-		UE_LOG(LogInit, Error, TEXT("ERROR: FMaskWidgetStyle::RemoveMaskClickClip invalid ClipIndex = %d, MaskClips.Num() = %d"), ClipIndex, MaskClips.Num());
-	}
-	return false;
-}
+#include "MaskSlateStyle.h"
+
+uint32 FMaskClip::NextRevision = 0;
+
+FMaskWidgetStyle::FMaskWidgetStyle()
+: BackgroundImage()
+, MaxClipCount(16)
+{
+}
+
+bool FMaskClipShape::IsInside(const FVector2D& UV, const FVector2D& ClipSize) const
+{
+	// Keep in sync with the clip shape function of the mask material
+	switch (Type)
+	{
+	case EMaskClipShapeType::RoundedRect:
+	{
+		const FVector2D HalfSize = ClipSize * 0.5f;
+		const float Radius = FMath::Min(CornerRadius, HalfSize.GetMin());
+		const FVector2D Q = (UV * ClipSize - HalfSize).GetAbs() - (HalfSize - FVector2D(Radius, Radius));
+		const float Distance = FVector2D(FMath::Max(Q.X, 0.f), FMath::Max(Q.Y, 0.f)).Size() + FMath::Min(Q.GetMax(), 0.f) - Radius;
+		return Distance < 0.f;
+	}
+	case EMaskClipShapeType::Polygon:
+	{
+		const int32 NumPoints = FMath::Min<int32>(Points.Num(), MAX_MASK_CLIP_POLYGON_POINTS);
+		if (NumPoints < 3)
+		{
+			return false;
+		}
+
+		// Either winding, the point has to be on the inner side of every edge
+		float Winding = 0.f;
+		for (int32 i = 0; i < NumPoints; i++)
+		{
+			Winding += FVector2D::CrossProduct(Points[i] * ClipSize, Points[(i + 1) % NumPoints] * ClipSize);
+		}
+
+		const FVector2D Point = UV * ClipSize;
+		for (int32 i = 0; i < NumPoints; i++)
+		{
+			const FVector2D A = Points[i] * ClipSize;
+			const FVector2D B = Points[(i + 1) % NumPoints] * ClipSize;
+			if (FVector2D::CrossProduct(B - A, Point - A) * Winding <= 0.f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	case EMaskClipShapeType::Texture:
+	case EMaskClipShapeType::Ellipse:
+	default:
+		return FVector2D::DistSquared(UV - 0.5f, FVector2D::ZeroVector) < 0.25f;
+	}
+}
+
+UTexture2D* FMaskClip::GetMaskTexture() const
+{
+	// Picks up MaskTex once streamed in, or assigned from the details panel
+	LoadedMaskTex = MaskTex.Get();
+	return LoadedMaskTex;
+}
+
+const FMaskHitTestBitmap* FMaskClip::GetHitTestBitmap() const
+{
+	// The cache keeps the bitmap alive, Invalidate replaces it there after a reimport
+	return FMaskHitTestBitmap::Find(GetMaskTexture());
+}
+
+void FMaskWidgetStyle::GetResources(TArray< const FSlateBrush* >& OutBrushes) const
+{
+	OutBrushes.Add(&BackgroundImage);
+}
+
+const FName FMaskWidgetStyle::TypeName(TEXT("FMaskWidgetStyle"));
+
+const FMaskWidgetStyle& FMaskWidgetStyle::GetDefault()
+{
+	static FMaskWidgetStyle Default;
+	return Default;
+}
+
+void FMaskWidgetStyle::ReIndexClip()
+{
+	for (uint8 i = 0; i < MaskClips.Num(); i++)
+	{
+		MaskClips[i].SetIndex(i);
+	}
+}
+
+const UTexture2D* FMaskWidgetStyle::GetMaskTextureByIdx(const int32& Index) const
+{
+	if (MaskClips.Num() > Index)
+	{
+		return MaskClips[Index].GetMaskTexture();
+	}
+	return nullptr;
+}
+
+const FMaskHitTestBitmap* FMaskWidgetStyle::GetHitTestBitmapByIdx(const int32& Index) const
+{
+	if (Index >= 0 && MaskClips.Num() > Index)
+	{
+		return MaskClips[Index].GetHitTestBitmap();
+	}
+	return nullptr;
+}
+
+const FMaskClipShape* FMaskWidgetStyle::GetMaskShapeByIdx(const int32& Index) const
+{
+	if (Index >= 0 && MaskClips.Num() > Index)
+	{
+		return &MaskClips[Index].GetShape();
+	}
+	return nullptr;
+}
+
+bool FMaskWidgetStyle::SetMaskShape(const int32& Index, const FMaskClipShape& Shape)
+{
+	if (MaskClips.Num() > Index)
+	{
+		MaskClips[Index].SetShape(Shape);
+		return true;
+	}
+	return false;
+}
+
+bool FMaskWidgetStyle::SetMaskTextureByIdx(const int32& Index, UTexture2D* Texture)
+{
+	if (MaskClips.Num() > Index)
+	{
+		MaskClips[Index].SetMaskTexture(Texture);
+		return true;
+	}
+	return false;
+}
+
+bool FMaskWidgetStyle::SetMaskTextureByIdx(const int32& Index, const TSoftObjectPtr<UTexture2D>& Texture)
+{
+	if (MaskClips.Num() > Index)
+	{
+		MaskClips[Index].SetMaskTexture(Texture);
+		return true;
+	}
+	return false;
+}
+
+void FMaskWidgetStyle::GetPendingMaskTextures(TArray<FSoftObjectPath>& OutPaths) const
+{
+	for (const FMaskClip& Clip : MaskClips)
+	{
+		if (!Clip.GetShape().IsAnalytic() && Clip.IsMaskTexturePending())
+		{
+			OutPaths.AddUnique(Clip.GetSoftMaskTexture().ToSoftObjectPath());
+		}
+	}
+}
+
+bool FMaskWidgetStyle::SetMaskSize(const int32& Index, const FVector2D& Size)
+{
+	if (MaskClips.Num() > Index)
+	{
+		MaskClips[Index].SetSize(Size);
+		return true;
+	}
+	return false;
+}
+
+bool FMaskWidgetStyle::SetMaskSizeXY(const int32& Index, const float& X, const float& Y)
+{
+	return SetMaskSize(Index, FVector2D(X, Y));
+}
+
+bool FMaskWidgetStyle::SetMaskPos(const int32& Index, const FVector2D& Pos)
+{
+	if (MaskClips.Num() > Index)
+	{
+		MaskClips[Index].SetPosition(Pos);
+		return true;
+	}
+	return false;
+}
+
+bool FMaskWidgetStyle::SetMaskPosXY(const int32& Index, const float& X, const float& Y)
+{
+	return SetMaskPos(Index, FVector2D(X, Y));
+}
+
+bool FMaskWidgetStyle::SetMaskPosSize(const int32& Index, const FVector4& PosSize)
+{
+	return SetMaskPosSizeXYZW(Index, PosSize.X, PosSize.Y, PosSize.Z, PosSize.W);
+}
+
+bool FMaskWidgetStyle::SetMaskPosSizeXYZW(const int32& Index, const float& X, const float& Y, const float& Z, const float& W)
+{
+	if (MaskClips.Num() > Index)
+	{
+		MaskClips[Index].SetPosition(FVector2D(X, Y));
+		MaskClips[Index].SetSize(FVector2D(Z, W));
+		return true;
+	}
+	return false;
+}
+
+bool FMaskWidgetStyle::EnableMaskClickClip(const int32& Index, bool Enable)
+{
+	if (MaskClips.Num() > Index)
+	{
+		MaskClips[Index].SetEnable(Enable);
+		return true;
+	}
+	return false;
+}
+
+int32 FMaskWidgetStyle::AddMaskClickClip(const FVector2D& Position, const FVector2D& Size, UTexture2D* Mask)
+{
+	int32 Count = MaskClips.Num();
+	if (Count < FMath::Min<int32>(MaxClipCount, MAX_MASK_CLIP_COUNT))
+	{
+		MaskClips.Add(FMaskClip(Count, Position, Size, Mask));
+		return Count;
+	}
+	return -1;
+}
+
+bool FMaskWidgetStyle::RemoveMaskClickClip(const int32& ClipIndex)
+{
+	if (ClipIndex >= 0 && ClipIndex < MaskClips.Num())
+	{
+		MaskClips.RemoveAt(ClipIndex);
+		// Following clips moved down a slot
+		for (int32 i = ClipIndex; i < MaskClips.Num(); i++)
+		{
+			MaskClips[i].MarkDirty(EMaskClipDirty::All);
+		}
+		return true;
+	}
+	else
+	{
+		UE_LOG(LogInit, Error, TEXT("ERROR: FMaskWidgetStyle::RemoveMaskClickClip invalid ClipIndex = %d, MaskClips.Num() = %d"), ClipIndex, MaskClips.Num());
+	}
+	return false;
+}
+
+bool FMaskWidgetStyle::SetMaskClips(TArrayView<const FMaskClipDesc> Clips)
+{
+	if (Clips.Num() > FMath::Min<int32>(MaxClipCount, MAX_MASK_CLIP_COUNT))
+	{
+		UE_LOG(LogInit, Error, TEXT("ERROR: FMaskWidgetStyle::SetMaskClips too many clips = %d, MaxClipCount = %d"), Clips.Num(), MaxClipCount);
+		return false;
+	}
+
+	if (MaskClips.Num() > Clips.Num())
+	{
+		MaskClips.RemoveAt(Clips.Num(), MaskClips.Num() - Clips.Num());
+	}
+
+	for (int32 i = 0; i < Clips.Num(); i++)
+	{
+		const FMaskClipDesc& Desc = Clips[i];
+		if (i == MaskClips.Num())
+		{
+			MaskClips.Add(FMaskClip(i, Desc.Position, Desc.Size, nullptr));
+		}
+
+		FMaskClip& Clip = MaskClips[i];
+		Clip.SetPosition(Desc.Position);
+		Clip.SetSize(Desc.Size);
+		Clip.SetMaskTexture(Desc.MaskTex);
+		Clip.SetEnable(Desc.ClipEnable);
+		Clip.SetShape(Desc.Shape);
+	}
+	return true;
+}
+
+void FMaskWidgetStyle::MarkClipsDirty(EMaskClipDirty Flags)
+{
+	for (FMaskClip& Clip : MaskClips)
+	{
+		Clip.MarkDirty(Flags);
+	}
+}
+
+void FMaskWidgetStyle::BuildHitTestBitmaps() const
+{
+	for (const FMaskClip& Clip : MaskClips)
+	{
+		if (UTexture2D* Texture = Clip.GetMaskTexture())
+		{
+			FMaskHitTestBitmap::FindOrBuild(Texture);
+		}
+	}
+}
+
+void FMaskWidgetStyle::GatherPaintData(FMaskClipPaintArray& OutClips) const
+{
+	const int32 PreviousNum = OutClips.Num();
+	OutClips.SetNumUninitialized(MaskClips.Num(), false);
+
+	for (int32 i = 0; i < MaskClips.Num(); i++)
+	{
+		const FMaskClip& Clip = MaskClips[i];
+		FMaskClipPaintData& PaintData = OutClips[i];
+
+		// Flags not pushed yet are kept, a new slot has nothing pushed
+		const EMaskClipDirty PendingFlags = i < PreviousNum ? PaintData.DirtyFlags | Clip.GetDirtyFlagsSince(PaintData.GatheredRevision) : EMaskClipDirty::All;
+
+		const FMaskClipShape& Shape = Clip.GetShape();
+		PaintData.Position = Clip.GetPos();
+		PaintData.Size = Clip.GetSize();
+		PaintData.Texture = Shape.IsAnalytic() ? nullptr : Clip.GetMaskTexture();
+		PaintData.bPending = !Shape.IsAnalytic() && Clip.IsMaskTexturePending();
+		PaintData.ShapeType = Shape.Type;
+		PaintData.CornerRadius = Shape.CornerRadius;
+		PaintData.Feather = Shape.Feather;
+		PaintData.NumPoints = FMath::Min<int32>(Shape.Points.Num(), MAX_MASK_CLIP_POLYGON_POINTS);
+		for (int32 PointIndex = 0; PointIndex < PaintData.NumPoints; PointIndex++)
+		{
+			PaintData.Points[PointIndex] = Shape.Points[PointIndex];
+		}
+		PaintData.bEnabled = Clip.IsEnable();
+		PaintData.DirtyFlags = PendingFlags;
+		PaintData.GatheredRevision = Clip.GetRevision();
+	}
+}
@@ -1,165 +1,441 @@
-// MIT License
-
-// Copyright (c) 2021 HankShu inkiu0@gmail.com
-
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Engine/Texture2D.h"
-#include "Styling/SlateBrush.h"
-#include "Styling/SlateWidgetStyle.h"
-#include "MaskSlateStyle.generated.h"
-
-static const uint8 MAX_MASK_CLIP_COUNT = 3;
-
-USTRUCT(BlueprintType)
-struct MMOGAME_API FMaskClip
-{
-	GENERATED_USTRUCT_BODY()
-
-public:
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
-	UTexture2D* MaskTex;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
-	FVector2D MaskPosition;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
-	FVector2D MaskSize;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
-	bool ClipEnable = false;
-
-private:
-
-	int32 ClipIndex;
-
-public:
-
-	/**
-	 * Default constructor.
-	 */
-	FMaskClip()
-		: MaskTex(nullptr)
-		, MaskPosition(0.f, 0.f)
-		, MaskSize(32.f, 32.f)
-		, ClipEnable(false)
-		, ClipIndex(-1)
-	{ }
-
-	FMaskClip(const int32& Index, const FVector2D& Pos, const FVector2D& Size, UTexture2D* Mask)
-	{
-		ClipIndex = Index;
-		MaskPosition = Pos;
-		MaskSize = Size;
-		MaskTex = Mask;
-	}
-
-	virtual ~FMaskClip() {}
-
-	void SetMaskTexture(UTexture2D* const Texture) { MaskTex = Texture; }
-
-	void SetSize(const FVector2D& Size) { MaskSize = Size; }
-
-	void SetPosition(const FVector2D& Pos) { MaskPosition = Pos; }
-
-	void SetEnable(bool Enable) { ClipEnable = Enable; }
-
-	void SetIndex(const int32& Index) { ClipIndex = Index; }
-
-	UTexture2D* GetMaskTexture() const { return MaskTex; }
-
-	FVector2D GetSize() const { return MaskSize; }
-
-	FVector2D GetPos() const { return MaskPosition; }
-
-	bool IsEnable() const { return ClipEnable; }
-
-	int32 GetClipIndex() const { return ClipIndex; }
-};
-
-/**
- * Represents the appearance of an SMaskWidget
- */
-USTRUCT(BlueprintType)
-struct MMOGAME_API FMaskWidgetStyle : public FSlateWidgetStyle
-{
-	GENERATED_USTRUCT_BODY()
-
-public:
-
-	FMaskWidgetStyle();
-
-	virtual ~FMaskWidgetStyle() {}
-
-	virtual void GetResources(TArray< const FSlateBrush* >& OutBrushes) const override;
-
-	static const FName TypeName;
-	virtual const FName GetTypeName() const override { return TypeName; };
-
-	static const FMaskWidgetStyle& GetDefault();
-
-	/** Background image to use for the mask widget */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Appearance)
-	FSlateBrush BackgroundImage;
-	FMaskWidgetStyle& SetBackgroundImage(const FSlateBrush& InBackgroundImage) { BackgroundImage = InBackgroundImage; return *this; }
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Appearance)
-	TArray<FMaskClip> MaskClips;
-
-	void ReIndexClip();
-
-	const UTexture2D* GetMaskTextureByIdx(const int32& Index) const;
-
-	bool SetMaskTextureByIdx(const int32& Index, UTexture2D* Texture);
-
-	bool SetMaskSize(const int32& Index, const FVector2D& Size);
-
-	bool SetMaskSizeXY(const int32& Index, const float& X, const float& Y);
-
-	bool SetMaskPos(const int32& Index, const FVector2D& Pos);
-
-	bool SetMaskPosXY(const int32& Index, const float& X, const float& Y);
-
-	bool SetMaskPosSize(const int32& Index, const FVector4& PosSize);
-
-	bool SetMaskPosSizeXYZW(const int32& Index, const float& X, const float& Y, const float& Z, const float& W);
-
-	bool EnableMaskClickClip(const int32& Index, bool Enable);
-
-	int32 AddMaskClickClip(const FVector2D& Position, const FVector2D& Size, UTexture2D* Mask);
-
-	bool RemoveMaskClickClip(const int32& ClipIndex);
-
-	UPROPERTY(Transient)
-	FSlateBrush MaskMatBrush;
-
-public:
-
-	/**
-	* Unlinks all colors in this style.
-	* @see FSlateColor::Unlink
-	*/
-	void UnlinkColors()
-	{
-		BackgroundImage.UnlinkColors();
-	}
-};
+// MIT License
+
+// Copyright (c) 2021 HankShu inkiu0@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Texture2D.h"
+#include "Styling/SlateBrush.h"
+#include "Styling/SlateWidgetStyle.h"
+#include "MaskHitTestBitmap.h"
+#include "MaskSlateStyle.generated.h"
+
+/** Clips a mask material can take, materials with ClipData have no other limit (see FMaskClipRenderData) */
+static const uint8 MAX_MASK_CLIP_COUNT = 64;
+
+/** Clips of materials still using the MaskUV_%d / MaskTex_%d parameters */
+static const uint8 LEGACY_MASK_CLIP_COUNT = 3;
+
+/** Points a polygon clip can have, ClipData has room for that many per clip */
+static const uint8 MAX_MASK_CLIP_POLYGON_POINTS = 8;
+
+/** What changed on a clip since SMaskWidget last pushed it to the mask material */
+enum class EMaskClipDirty : uint8
+{
+	None		= 0,
+	Geometry	= 1 << 0,	// MaskPosition / MaskSize
+	Texture		= 1 << 1,	// MaskTex
+	Enable		= 1 << 2,	// ClipEnable
+	Shape		= 1 << 3,	// Shape
+	All			= Geometry | Texture | Enable | Shape,
+};
+ENUM_CLASS_FLAGS(EMaskClipDirty)
+
+/** Bits of EMaskClipDirty, a clip keeps the revision each of them last changed at */
+static const int32 MASK_CLIP_DIRTY_BIT_COUNT = 4;
+
+/** How a clip cuts the mask */
+UENUM(BlueprintType)
+enum class EMaskClipShapeType : uint8
+{
+	/** Alpha of MaskTex, an ellipse filling the clip when there is no MaskTex */
+	Texture,
+	/** Ellipse filling the clip */
+	Ellipse,
+	/** The clip's rect with rounded corners */
+	RoundedRect,
+	/** Convex polygon of Points */
+	Polygon,
+};
+
+/**
+ * Analytic outline of a clip, drawn by the material and hit tested on the CPU with the same formulas, no texture needed.
+ * See FMaskClipRenderData for how it reaches the material.
+ */
+USTRUCT(BlueprintType)
+struct MMOGAME_API FMaskClipShape
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	EMaskClipShapeType Type = EMaskClipShapeType::Texture;
+
+	/** Corner radius of a RoundedRect, in slate units */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip, meta = (ClampMin = "0", EditCondition = "Type == EMaskClipShapeType::RoundedRect"))
+	float CornerRadius = 0.f;
+
+	/** Points of a convex Polygon normalized to the clip, (0, 0) is its top left and (1, 1) its bottom right */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip, meta = (EditCondition = "Type == EMaskClipShapeType::Polygon"))
+	TArray<FVector2D> Points;
+
+	/** Width of the soft edge the material draws across the outline, in slate units. Hit tests use the outline itself. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip, meta = (ClampMin = "0"))
+	float Feather = 0.f;
+
+	/** Drawn and hit tested without MaskTex */
+	bool IsAnalytic() const { return Type != EMaskClipShapeType::Texture; }
+
+	/**
+	 * Is a point of a clip of ClipSize slate units inside the outline, where clicks go through.
+	 * @param UV	The point normalized to the clip.
+	 */
+	bool IsInside(const FVector2D& UV, const FVector2D& ClipSize) const;
+
+	bool operator==(const FMaskClipShape& Other) const
+	{
+		return Type == Other.Type && CornerRadius == Other.CornerRadius && Points == Other.Points && Feather == Other.Feather;
+	}
+
+	bool operator!=(const FMaskClipShape& Other) const { return !(*this == Other); }
+};
+
+USTRUCT(BlueprintType)
+struct MMOGAME_API FMaskClip
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	/** Streamed in by the widget showing the clip, the clip has no cutout until it is loaded */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	TSoftObjectPtr<UTexture2D> MaskTex;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	FVector2D MaskPosition;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	FVector2D MaskSize;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	bool ClipEnable = false;
+
+	/** Outline of the clip, MaskTex is only used by the Texture shape */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	FMaskClipShape Shape;
+
+private:
+
+	int32 ClipIndex;
+
+	/** MaskTex once loaded, keeps it loaded as long as the clip */
+	UPROPERTY(Transient)
+	mutable UTexture2D* LoadedMaskTex = nullptr;
+
+	/** Revision each EMaskClipDirty bit last changed at, every widget painting the clip compares them to the revision it gathered */
+	uint32 DirtyRevisions[MASK_CLIP_DIRTY_BIT_COUNT] = {};
+
+	/** Latest of DirtyRevisions */
+	uint32 Revision = 0;
+
+	/** Revisions are shared by all clips, a clip moved or added to a slot is newer than anything gathered from it */
+	static uint32 NextRevision;
+
+public:
+
+	/**
+	 * Default constructor.
+	 */
+	FMaskClip()
+		: MaskTex(nullptr)
+		, MaskPosition(0.f, 0.f)
+		, MaskSize(32.f, 32.f)
+		, ClipEnable(false)
+		, ClipIndex(-1)
+	{
+		MarkDirty(EMaskClipDirty::All);
+	}
+
+	FMaskClip(const int32& Index, const FVector2D& Pos, const FVector2D& Size, UTexture2D* Mask)
+	{
+		ClipIndex = Index;
+		MaskPosition = Pos;
+		MaskSize = Size;
+		MaskTex = Mask;
+		LoadedMaskTex = Mask;
+		FMaskHitTestBitmap::FindOrBuild(Mask);
+		MarkDirty(EMaskClipDirty::All);
+	}
+
+	void SetMaskTexture(UTexture2D* const Texture)
+	{
+		SetMaskTexture(TSoftObjectPtr<UTexture2D>(Texture));
+	}
+
+	void SetMaskTexture(const TSoftObjectPtr<UTexture2D>& Texture)
+	{
+		if (MaskTex != Texture)
+		{
+			MaskTex = Texture;
+			LoadedMaskTex = Texture.Get();
+			FMaskHitTestBitmap::FindOrBuild(LoadedMaskTex);
+			MarkDirty(EMaskClipDirty::Texture);
+		}
+	}
+
+	void SetSize(const FVector2D& Size)
+	{
+		if (MaskSize != Size)
+		{
+			MaskSize = Size;
+			MarkDirty(EMaskClipDirty::Geometry);
+		}
+	}
+
+	void SetPosition(const FVector2D& Pos)
+	{
+		if (MaskPosition != Pos)
+		{
+			MaskPosition = Pos;
+			MarkDirty(EMaskClipDirty::Geometry);
+		}
+	}
+
+	void SetEnable(bool Enable)
+	{
+		if (ClipEnable != Enable)
+		{
+			ClipEnable = Enable;
+			MarkDirty(EMaskClipDirty::Enable);
+		}
+	}
+
+	void SetShape(const FMaskClipShape& InShape)
+	{
+		if (Shape != InShape)
+		{
+			Shape = InShape;
+			MarkDirty(EMaskClipDirty::Shape);
+		}
+	}
+
+	void MarkDirty(EMaskClipDirty Flags)
+	{
+		Revision = ++NextRevision;
+		for (int32 Bit = 0; Bit < MASK_CLIP_DIRTY_BIT_COUNT; Bit++)
+		{
+			if (EnumHasAnyFlags(Flags, static_cast<EMaskClipDirty>(1 << Bit)))
+			{
+				DirtyRevisions[Bit] = Revision;
+			}
+		}
+	}
+
+	/** What changed since the clip was gathered at GatheredRevision */
+	EMaskClipDirty GetDirtyFlagsSince(uint32 GatheredRevision) const
+	{
+		EMaskClipDirty Flags = EMaskClipDirty::None;
+		if (Revision > GatheredRevision)
+		{
+			for (int32 Bit = 0; Bit < MASK_CLIP_DIRTY_BIT_COUNT; Bit++)
+			{
+				if (DirtyRevisions[Bit] > GatheredRevision)
+				{
+					Flags |= static_cast<EMaskClipDirty>(1 << Bit);
+				}
+			}
+		}
+		return Flags;
+	}
+
+	uint32 GetRevision() const { return Revision; }
+
+	void SetIndex(const int32& Index) { ClipIndex = Index; }
+
+	/** MaskTex if it is loaded, null while it streams in */
+	UTexture2D* GetMaskTexture() const;
+
+	const TSoftObjectPtr<UTexture2D>& GetSoftMaskTexture() const { return MaskTex; }
+
+	/** MaskTex is set but not loaded yet */
+	bool IsMaskTexturePending() const { return !MaskTex.IsNull() && GetMaskTexture() == nullptr; }
+
+	/** Click-through bitmap of MaskTex, looked up in the shared cache so a reimported texture is picked up. Never builds it. */
+	const FMaskHitTestBitmap* GetHitTestBitmap() const;
+
+	FVector2D GetSize() const { return MaskSize; }
+
+	FVector2D GetPos() const { return MaskPosition; }
+
+	bool IsEnable() const { return ClipEnable; }
+
+	const FMaskClipShape& GetShape() const { return Shape; }
+
+	int32 GetClipIndex() const { return ClipIndex; }
+};
+
+/** Everything a clip is made of, to set all the clips in one call (see FMaskWidgetStyle::SetMaskClips) */
+USTRUCT(BlueprintType)
+struct MMOGAME_API FMaskClipDesc
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	FVector2D Position = FVector2D(0.f, 0.f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	FVector2D Size = FVector2D(32.f, 32.f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	TSoftObjectPtr<UTexture2D> MaskTex;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	bool ClipEnable = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MaskClip)
+	FMaskClipShape Shape;
+};
+
+/**
+ * Paint-time copy of a clip.
+ * Plain data so the paint path iterates it in place, without copying FMaskClip or the MaskClips array.
+ */
+struct FMaskClipPaintData
+{
+	FVector2D Position;
+
+	FVector2D Size;
+
+	/** MaskTex, null for analytic shapes and while MaskTex streams in */
+	UTexture2D* Texture;
+
+	/** MaskTex is streaming in, the clip is drawn without cutout and hit tested with its analytic shape */
+	bool bPending;
+
+	EMaskClipShapeType ShapeType;
+
+	float CornerRadius;
+
+	float Feather;
+
+	/** Polygon points past MAX_MASK_CLIP_POLYGON_POINTS are dropped */
+	int32 NumPoints;
+
+	FVector2D Points[MAX_MASK_CLIP_POLYGON_POINTS];
+
+	/** Changes not pushed to the material yet */
+	EMaskClipDirty DirtyFlags;
+
+	/** Revision of the clip when it was last gathered, see FMaskClip::GetDirtyFlagsSince */
+	uint32 GatheredRevision;
+
+	bool bEnabled;
+
+	bool IsDirty(EMaskClipDirty Flags) const { return EnumHasAnyFlags(DirtyFlags, Flags); }
+};
+
+using FMaskClipPaintArray = TArray<FMaskClipPaintData, TInlineAllocator<8>>;
+
+/**
+ * Represents the appearance of an SMaskWidget
+ */
+USTRUCT(BlueprintType)
+struct MMOGAME_API FMaskWidgetStyle : public FSlateWidgetStyle
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FMaskWidgetStyle();
+
+	virtual ~FMaskWidgetStyle() {}
+
+	virtual void GetResources(TArray< const FSlateBrush* >& OutBrushes) const override;
+
+	static const FName TypeName;
+	virtual const FName GetTypeName() const override { return TypeName; };
+
+	static const FMaskWidgetStyle& GetDefault();
+
+	/** Background image to use for the mask widget */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Appearance)
+	FSlateBrush BackgroundImage;
+	FMaskWidgetStyle& SetBackgroundImage(const FSlateBrush& InBackgroundImage) { BackgroundImage = InBackgroundImage; return *this; }
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Appearance)
+	TArray<FMaskClip> MaskClips;
+
+	/** Clips AddMaskClickClip accepts, materials without ClipData only draw the first LEGACY_MASK_CLIP_COUNT */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Appearance, meta = (ClampMin = "1", ClampMax = "64"))
+	int32 MaxClipCount;
+
+	void ReIndexClip();
+
+	const UTexture2D* GetMaskTextureByIdx(const int32& Index) const;
+
+	const FMaskHitTestBitmap* GetHitTestBitmapByIdx(const int32& Index) const;
+
+	const FMaskClipShape* GetMaskShapeByIdx(const int32& Index) const;
+
+	bool SetMaskShape(const int32& Index, const FMaskClipShape& Shape);
+
+	bool SetMaskTextureByIdx(const int32& Index, UTexture2D* Texture);
+
+	bool SetMaskTextureByIdx(const int32& Index, const TSoftObjectPtr<UTexture2D>& Texture);
+
+	/** MaskTex of the clips that are set but not loaded yet */
+	void GetPendingMaskTextures(TArray<FSoftObjectPath>& OutPaths) const;
+
+	bool SetMaskSize(const int32& Index, const FVector2D& Size);
+
+	bool SetMaskSizeXY(const int32& Index, const float& X, const float& Y);
+
+	bool SetMaskPos(const int32& Index, const FVector2D& Pos);
+
+	bool SetMaskPosXY(const int32& Index, const float& X, const float& Y);
+
+	bool SetMaskPosSize(const int32& Index, const FVector4& PosSize);
+
+	bool SetMaskPosSizeXYZW(const int32& Index, const float& X, const float& Y, const float& Z, const float& W);
+
+	bool EnableMaskClickClip(const int32& Index, bool Enable);
+
+	int32 AddMaskClickClip(const FVector2D& Position, const FVector2D& Size, UTexture2D* Mask);
+
+	bool RemoveMaskClickClip(const int32& ClipIndex);
+
+	/** Make MaskClips match Clips, only what differs is marked dirty. Fails without changes past MaxClipCount. */
+	bool SetMaskClips(TArrayView<const FMaskClipDesc> Clips);
+
+	/**
+	 * Copy the clips to OutClips, adding what changed since OutClips was last gathered to its dirty flags.
+	 * Leaves the clips untouched so every widget painting the style sees every change. Doesn't allocate while the clip count fits OutClips.
+	 */
+	void GatherPaintData(FMaskClipPaintArray& OutClips) const;
+
+	/** Push Flags of every clip on the next paint, e.g. after editing MaskClips in the details panel */
+	void MarkClipsDirty(EMaskClipDirty Flags);
+
+	/** Build the click-through bitmap of every clip's MaskTex that is loaded, keeps bitmap builds off the input path */
+	void BuildHitTestBitmaps() const;
+
+public:
+
+	/**
+	* Unlinks all colors in this style.
+	* @see FSlateColor::Unlink
+	*/
+	void UnlinkColors()
+	{
+		BackgroundImage.UnlinkColors();
+	}
+};
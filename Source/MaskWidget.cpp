@@ -1,215 +1,321 @@
-#include "MaskWidget.h"
-#include "CanvasPanelSlot.h"
-#include "Engine/Texture2D.h"
-#include "Slate/SlateBrushAsset.h"
-
-#define LOCTEXT_NAMESPACE "UMG"
-
-UMaskWidget::UMaskWidget(const FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer)
-	, BgColorAndOpacity(FLinearColor::White)
-{
-
-}
-
-TSharedRef<SWidget> UMaskWidget::RebuildWidget()
-{
-	MyMask = SNew(SMaskWidget).Style(&WidgetStyle);
-
-	MyMask->ReIndexClip();
-
-	return MyMask.ToSharedRef();
-}
-
-void UMaskWidget::SynchronizeProperties()
-{
-	Super::SynchronizeProperties();
-	TAttribute<FSlateColor> ColorAndOpacityBinding = PROPERTY_BINDING(FSlateColor, BgColorAndOpacity);
-	if(MyMask.IsValid())
-	{
-		MyMask->SetStyle(&WidgetStyle);
-		MyMask->SetBgColorAndOpacity(BgColorAndOpacity);
-	}
-}
-
-void UMaskWidget::SetBgColorAndOpacity(FLinearColor InColorAndOpacity)
-{
-	BgColorAndOpacity = InColorAndOpacity;
-	if (MyMask.IsValid())
-	{
-		MyMask->SetBgColorAndOpacity(BgColorAndOpacity);
-	}
-}
-
-void UMaskWidget::SetBgOpacity(float InOpacity)
-{
-	BgColorAndOpacity.A = InOpacity;
-	if (MyMask.IsValid())
-	{
-		MyMask->SetBgColorAndOpacity(BgColorAndOpacity);
-	}
-}
-
-void UMaskWidget::ReleaseSlateResources(bool bReleaseChildren)
-{
-	Super::ReleaseSlateResources(bReleaseChildren);
-
-	MyMask.Reset();
-}
-
-void UMaskWidget::SetMaskPos(const int32& ClipIndex, const FVector2D& Pos)
-{
-	if (WidgetStyle.SetMaskPos(ClipIndex, Pos))
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::SetMaskPosXY(const int32& ClipIndex, const float& X, const float& Y)
-{
-	if (WidgetStyle.SetMaskPosXY(ClipIndex, X, Y))
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::SetMaskSize(const int32& ClipIndex, const FVector2D& Size)
-{
-	if (WidgetStyle.SetMaskSize(ClipIndex, Size))
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::SetMaskSizeXY(const int32& ClipIndex, const float& X, const float& Y)
-{
-	if (WidgetStyle.SetMaskSizeXY(ClipIndex, X, Y))
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::SetMaskPosSize(const int32& ClipIndex, const FVector4& PosSize)
-{
-	if (WidgetStyle.SetMaskPosSize(ClipIndex, PosSize))
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::SetMaskPosSizeXYZW(const int32& ClipIndex, const float& X, const float& Y, const float& Z, const float& W)
-{
-	if (WidgetStyle.SetMaskPosSizeXYZW(ClipIndex, X, Y, Z, W))
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::SetBrushTintColor(FSlateColor TintColor)
-{
-	if (WidgetStyle.BackgroundImage.TintColor != TintColor)
-	{
-		WidgetStyle.BackgroundImage.TintColor = TintColor;
-
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::SetBgImage(UTexture2D* Tex, bool bMatchSize)
-{
-	if (Tex)
-	{
-		WidgetStyle.BackgroundImage.SetResourceObject(Tex);
-
-		if (bMatchSize)
-		{
-			WidgetStyle.BackgroundImage.ImageSize.X = Tex->GetSizeX();
-			WidgetStyle.BackgroundImage.ImageSize.Y = Tex->GetSizeY();
-		}
-
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::SetMaskImage(const int32& ClipIndex, UTexture2D* Tex)
-{
-	if (Tex && WidgetStyle.SetMaskTextureByIdx(ClipIndex, Tex))
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-void UMaskWidget::EnableMaskClickClip(const int32& ClipIndex, bool Enable)
-{
-	if (WidgetStyle.EnableMaskClickClip(ClipIndex, Enable))
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-}
-
-int32 UMaskWidget::AddMaskClickClip(const FVector2D& Position, const FVector2D& Size, UTexture2D* Mask)
-{
-	int32 Index = WidgetStyle.AddMaskClickClip(Position, Size, Mask);
-	if (Index > -1)
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-	return Index;
-}
-
-bool UMaskWidget::RemoveMaskClickClip(const int32& ClipIndex)
-{
-	bool Ret = WidgetStyle.RemoveMaskClickClip(ClipIndex);
-	if (Ret)
-	{
-		if (MyMask.IsValid())
-		{
-			MyMask->SetStyle(&WidgetStyle);
-		}
-	}
-	return Ret;
-}
-
-#if WITH_EDITOR
-
-const FText UMaskWidget::GetPaletteCategory()
-{
-	return LOCTEXT("Mask Widget", "Mask Widget");
-}
-
-#endif
-
-#undef LOCTEXT_NAMESPACE
+#include "MaskWidget.h"
+#include "CanvasPanelSlot.h"
+#include "Engine/Texture2D.h"
+#include "MaskHitTestUserData.h"
+#include "Slate/SlateBrushAsset.h"
+
+#define LOCTEXT_NAMESPACE "UMG"
+
+UMaskWidget::UMaskWidget(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, BgColorAndOpacity(FLinearColor::White)
+{
+
+}
+
+TSharedRef<SWidget> UMaskWidget::RebuildWidget()
+{
+	MyMask = SNew(SMaskWidget).Style(&WidgetStyle);
+
+	MyMask->ReIndexClip();
+
+	return MyMask.ToSharedRef();
+}
+
+void UMaskWidget::SynchronizeProperties()
+{
+	Super::SynchronizeProperties();
+	TAttribute<FSlateColor> ColorAndOpacityBinding = PROPERTY_BINDING(FSlateColor, BgColorAndOpacity);
+	if(MyMask.IsValid())
+	{
+		// MaskClips may have been edited in place from the details panel
+		WidgetStyle.MarkClipsDirty(EMaskClipDirty::All);
+		WidgetStyle.BuildHitTestBitmaps();
+		MyMask->SetStyle(&WidgetStyle);
+		MyMask->SetBgColorAndOpacity(BgColorAndOpacity);
+	}
+}
+
+void UMaskWidget::SetBgColorAndOpacity(FLinearColor InColorAndOpacity)
+{
+	BgColorAndOpacity = InColorAndOpacity;
+	if (MyMask.IsValid())
+	{
+		MyMask->SetBgColorAndOpacity(BgColorAndOpacity);
+	}
+}
+
+void UMaskWidget::SetBgOpacity(float InOpacity)
+{
+	BgColorAndOpacity.A = InOpacity;
+	if (MyMask.IsValid())
+	{
+		MyMask->SetBgColorAndOpacity(BgColorAndOpacity);
+	}
+}
+
+void UMaskWidget::ReleaseSlateResources(bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+
+	MyMask.Reset();
+}
+
+void UMaskWidget::SetMaskPos(const int32& ClipIndex, const FVector2D& Pos)
+{
+	if (WidgetStyle.SetMaskPos(ClipIndex, Pos))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetMaskPosXY(const int32& ClipIndex, const float& X, const float& Y)
+{
+	if (WidgetStyle.SetMaskPosXY(ClipIndex, X, Y))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetMaskSize(const int32& ClipIndex, const FVector2D& Size)
+{
+	if (WidgetStyle.SetMaskSize(ClipIndex, Size))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetMaskSizeXY(const int32& ClipIndex, const float& X, const float& Y)
+{
+	if (WidgetStyle.SetMaskSizeXY(ClipIndex, X, Y))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetMaskPosSize(const int32& ClipIndex, const FVector4& PosSize)
+{
+	if (WidgetStyle.SetMaskPosSize(ClipIndex, PosSize))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetMaskPosSizeXYZW(const int32& ClipIndex, const float& X, const float& Y, const float& Z, const float& W)
+{
+	if (WidgetStyle.SetMaskPosSizeXYZW(ClipIndex, X, Y, Z, W))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetBrushTintColor(FSlateColor TintColor)
+{
+	if (WidgetStyle.BackgroundImage.TintColor != TintColor)
+	{
+		WidgetStyle.BackgroundImage.TintColor = TintColor;
+
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetBgImage(UTexture2D* Tex, bool bMatchSize)
+{
+	if (Tex)
+	{
+		WidgetStyle.BackgroundImage.SetResourceObject(Tex);
+
+		if (bMatchSize)
+		{
+			WidgetStyle.BackgroundImage.ImageSize.X = Tex->GetSizeX();
+			WidgetStyle.BackgroundImage.ImageSize.Y = Tex->GetSizeY();
+		}
+
+		// SMaskWidget raises Layout itself when ImageSize changed
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetMaskImage(const int32& ClipIndex, UTexture2D* Tex)
+{
+	if (Tex && WidgetStyle.SetMaskTextureByIdx(ClipIndex, Tex))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetMaskImageSoft(const int32& ClipIndex, TSoftObjectPtr<UTexture2D> Tex)
+{
+	if (!Tex.IsNull() && WidgetStyle.SetMaskTextureByIdx(ClipIndex, Tex))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::EnableMaskClickClip(const int32& ClipIndex, bool Enable)
+{
+	if (WidgetStyle.EnableMaskClickClip(ClipIndex, Enable))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void UMaskWidget::SetMaskShape(const int32& ClipIndex, const FMaskClipShape& Shape)
+{
+	if (WidgetStyle.SetMaskShape(ClipIndex, Shape))
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+}
+
+int32 UMaskWidget::AddMaskClickClip(const FVector2D& Position, const FVector2D& Size, UTexture2D* Mask)
+{
+	int32 Index = WidgetStyle.AddMaskClickClip(Position, Size, Mask);
+	if (Index > -1)
+	{
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+	return Index;
+}
+
+bool UMaskWidget::RemoveMaskClickClip(const int32& ClipIndex)
+{
+	bool Ret = WidgetStyle.RemoveMaskClickClip(ClipIndex);
+	if (Ret)
+	{
+		if (MyMask.IsValid())
+		{
+			MyMask->OnClipRemoved(ClipIndex);
+		}
+		UpdateMask(EInvalidateWidgetReason::Paint);
+	}
+	return Ret;
+}
+
+bool UMaskWidget::SetMaskClips(const TArray<FMaskClipDesc>& Clips)
+{
+	const int32 PreviousNum = WidgetStyle.MaskClips.Num();
+	if (!WidgetStyle.SetMaskClips(Clips))
+	{
+		return false;
+	}
+
+	if (MyMask.IsValid())
+	{
+		for (int32 i = PreviousNum - 1; i >= WidgetStyle.MaskClips.Num(); i--)
+		{
+			MyMask->OnClipRemoved(i);
+		}
+	}
+	UpdateMask(EInvalidateWidgetReason::Paint);
+	return true;
+}
+
+void UMaskWidget::BeginMaskUpdate()
+{
+	MaskUpdateDepth++;
+}
+
+void UMaskWidget::CommitMaskUpdate()
+{
+	if (MaskUpdateDepth <= 0)
+	{
+		UE_LOG(LogInit, Error, TEXT("ERROR: UMaskWidget::CommitMaskUpdate without BeginMaskUpdate"));
+		return;
+	}
+
+	if (--MaskUpdateDepth == 0 && PendingInvalidateReason != EInvalidateWidgetReason::None)
+	{
+		UpdateMask(EInvalidateWidgetReason::None);
+	}
+}
+
+void UMaskWidget::UpdateMask(EInvalidateWidgetReason Reason)
+{
+	PendingInvalidateReason |= Reason;
+	if (MaskUpdateDepth > 0)
+	{
+		return;
+	}
+
+	if (MyMask.IsValid())
+	{
+		MyMask->SetStyle(&WidgetStyle, PendingInvalidateReason);
+	}
+	PendingInvalidateReason = EInvalidateWidgetReason::None;
+}
+
+void UMaskWidget::AnimateMaskPosSize(const int32& ClipIndex, const FVector4& PosSize, float Duration, EEaseMode EaseMode)
+{
+	if (MyMask.IsValid())
+	{
+		MyMask->AnimateClip(ClipIndex, FVector2D(PosSize.X, PosSize.Y), FVector2D(PosSize.Z, PosSize.W), Duration, EaseMode);
+	}
+	else
+	{
+		// Nothing to animate before the widget is built
+		SetMaskPosSize(ClipIndex, PosSize);
+	}
+}
+
+void UMaskWidget::StopMaskAnimation(const int32& ClipIndex)
+{
+	if (MyMask.IsValid())
+	{
+		MyMask->StopClipAnimation(ClipIndex);
+	}
+}
+
+bool UMaskWidget::IsMaskAnimating(const int32& ClipIndex) const
+{
+	return MyMask.IsValid() && MyMask->IsClipAnimating(ClipIndex);
+}
+
+#if WITH_EDITOR
+
+const FText UMaskWidget::GetPaletteCategory()
+{
+	return LOCTEXT("Mask Widget", "Mask Widget");
+}
+
+void UMaskWidget::PreSave(const class ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+	// Only a cook builds sidecars, saving the widget in the editor never dirties its textures
+	if (TargetPlatform == nullptr)
+	{
+		return;
+	}
+
+	for (const FMaskClip& Clip : WidgetStyle.MaskClips)
+	{
+		if (Clip.GetShape().IsAnalytic() || Clip.GetSoftMaskTexture().IsNull())
+		{
+			continue;
+		}
+
+		UTexture2D* Texture = Clip.GetSoftMaskTexture().LoadSynchronous();
+		if (Texture == nullptr)
+		{
+			UE_LOG(LogInit, Error, TEXT("ERROR: UMaskWidget %s can't load MaskTex %s"), *GetPathName(), *Clip.GetSoftMaskTexture().ToString());
+			continue;
+		}
+
+		const bool bHadSidecar = UMaskHitTestUserData::Find(Texture) != nullptr;
+		const UMaskHitTestUserData* UserData = UMaskHitTestUserData::FindOrAdd(Texture);
+		if (UserData == nullptr || !UserData->IsValidData())
+		{
+			UE_LOG(LogInit, Error, TEXT("ERROR: UMaskWidget %s MaskTex %s has no hit-test sidecar, its click-through reads the mips and needs RGBA32"), *GetPathName(), *Texture->GetPathName());
+		}
+		else if (!bHadSidecar)
+		{
+			// Cooked with the texture unless it was cooked already, saving the texture keeps it for every cook
+			UE_LOG(LogInit, Warning, TEXT("UMaskWidget %s added the hit-test sidecar of %s while cooking, resave the texture"), *GetPathName(), *Texture->GetPathName());
+		}
+	}
+}
+
+#endif
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,644 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Algo/Reverse.h"
+#include "Engine/Texture2D.h"
+#include "HittestGrid.h"
+#include "Layout/SlateClickClippingState.h"
+#include "MaskHitTestBitmap.h"
+#include "MaskHitTestUserData.h"
+#include "MaskSlateStyle.h"
+#include "Misc/App.h"
+#include "Rendering/DrawElements.h"
+#include "Widgets/SWindow.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Layout/SBorder.h"
+
+namespace MaskWidgetTests
+{
+	static const FVector2D GridArea(2048.f, 2048.f);
+
+	/** A widget of a random layout and what the grid is expected to know about it */
+	struct FTestWidget
+	{
+		TSharedPtr<SButton> Widget;
+
+		/** Painted into the appended grid rather than the root one */
+		bool bAppended = false;
+
+		bool bInGrid = false;
+
+		int32 LayerId = 0;
+
+		FSlateRect Rect;
+
+		/** Absolute rect of the widget's click-through ClickClip */
+		TOptional<FSlateRect> ClickClip;
+	};
+
+	/**
+	 * Buttons painted under a window into a root grid and a grid appended to it. Shuffle moves, adds and removes them
+	 * and their ClickClips, the grids are updated in place like painting a frame does.
+	 */
+	struct FRandomLayout
+	{
+		FRandomLayout(int32 Seed, int32 NumWidgets)
+			: Random(Seed)
+			, Window(SNew(SWindow).ClientSize(GridArea))
+			, Root(SNew(SBorder).Visibility(EVisibility::SelfHitTestInvisible))
+			, AppendedGrid(MakeShared<FHittestGrid>())
+		{
+			Grid.SetHittestArea(FVector2D::ZeroVector, GridArea);
+			AppendedGrid->SetHittestArea(FVector2D::ZeroVector, GridArea);
+			AppendedGrid->SetOwner(&Root.Get());
+			Grid.AddGrid(AppendedGrid);
+
+			// Paint parent of every button, so their bubble paths are Window, Root, Button
+			FSlateWindowElementList ElementList(Window);
+			FPaintArgs RootArgs(&Window.Get(), Grid, FVector2D::ZeroVector, FApp::GetCurrentTime(), 0.f);
+			Root->Paint(RootArgs, FGeometry::MakeRoot(GridArea, FSlateLayoutTransform()), FSlateRect(FVector2D::ZeroVector, GridArea), ElementList, 0, FWidgetStyle(), true);
+
+			Widgets.SetNum(NumWidgets);
+			for (FTestWidget& TestWidget : Widgets)
+			{
+				TestWidget.Widget = SNew(SButton).IsEnabled(Random.FRand() > 0.2f);
+				TestWidget.bAppended = Random.FRand() < 0.25f;
+			}
+		}
+
+		void Shuffle()
+		{
+			// Distinct layers, the front-most widget under a point is never a tie
+			TArray<int32> Layers;
+			for (int32 i = 0; i < Widgets.Num(); i++)
+			{
+				Layers.Add(i + 1);
+			}
+			for (int32 i = Layers.Num() - 1; i > 0; i--)
+			{
+				Layers.Swap(i, Random.RandRange(0, i));
+			}
+
+			FSlateWindowElementList ElementList(Window);
+			for (int32 i = 0; i < Widgets.Num(); i++)
+			{
+				FTestWidget& TestWidget = Widgets[i];
+				FHittestGrid& WidgetGrid = TestWidget.bAppended ? AppendedGrid.Get() : Grid;
+				const TSharedRef<SWidget> Widget = TestWidget.Widget.ToSharedRef();
+
+				if (Random.FRand() < 0.15f)
+				{
+					if (TestWidget.bInGrid)
+					{
+						WidgetGrid.RemoveWidget(Widget);
+						TestWidget.bInGrid = false;
+						TestWidget.ClickClip.Reset();
+					}
+					continue;
+				}
+
+				// A few widgets big enough for the root cell
+				const FVector2D Size = Random.FRand() < 0.1f
+					? FVector2D(Random.FRandRange(600.f, 1600.f), Random.FRandRange(600.f, 1600.f))
+					: FVector2D(Random.FRandRange(8.f, 300.f), Random.FRandRange(8.f, 300.f));
+				const FVector2D Position((GridArea.X - Size.X) * Random.FRand(), (GridArea.Y - Size.Y) * Random.FRand());
+				TestWidget.Rect = FSlateRect(Position, Position + Size);
+				TestWidget.LayerId = Layers[i];
+
+				FPaintArgs Args(&Root.Get(), WidgetGrid, FVector2D::ZeroVector, FApp::GetCurrentTime(), 0.f);
+				Widget->Paint(Args, FGeometry::MakeRoot(Size, FSlateLayoutTransform(Position)), FSlateRect(FVector2D::ZeroVector, GridArea), ElementList, TestWidget.LayerId, FWidgetStyle(), true);
+				// The sort the brute force expects, whatever the paint passed
+				WidgetGrid.AddWidget(Widget, 0, TestWidget.LayerId, 0);
+				TestWidget.bInGrid = true;
+
+				const float ClipRoll = Random.FRand();
+				if (ClipRoll < 0.3f)
+				{
+					const FVector2D ClipSize = Size * Random.FRandRange(0.2f, 0.8f);
+					const FVector2D ClipPosition = Position + (Size - ClipSize) * Random.FRand();
+					TestWidget.ClickClip = FSlateRect(ClipPosition, ClipPosition + ClipSize);
+					WidgetGrid.AddClickClip(&Widget.Get(), MakeShareable(new FSlateClickClippingState(0, FGeometry::MakeRoot(ClipSize, FSlateLayoutTransform(ClipPosition)),
+						FOnClickClipClicked::CreateLambda([](const FVector2D&, const int32&) { return true; }))));
+				}
+				else if (ClipRoll < 0.45f && TestWidget.ClickClip.IsSet())
+				{
+					WidgetGrid.RemoveClickClip(&Widget.Get(), 0);
+					TestWidget.ClickClip.Reset();
+				}
+			}
+		}
+
+		FVector2D RandomPoint()
+		{
+			return FVector2D(Random.FRandRange(0.f, GridArea.X), Random.FRandRange(0.f, GridArea.Y));
+		}
+
+		/** Front-most widget under Point that doesn't let it through, scanning every widget */
+		const FTestWidget* BruteForceHit(const FVector2D& Point) const
+		{
+			const FTestWidget* BestHit = nullptr;
+			for (const FTestWidget& TestWidget : Widgets)
+			{
+				if (TestWidget.bInGrid && TestWidget.Rect.ContainsPoint(Point)
+					&& !(TestWidget.ClickClip.IsSet() && TestWidget.ClickClip->ContainsPoint(Point))
+					&& (BestHit == nullptr || TestWidget.LayerId > BestHit->LayerId))
+				{
+					BestHit = &TestWidget;
+				}
+			}
+			return BestHit;
+		}
+
+		/**
+		 * Distance from Start to Candidate along Direction if the grid may navigate there, same rules as
+		 * FHittestGrid::FindFocusableWidget: ahead of Start, across its swept rect, enabled.
+		 */
+		bool GetNavigationDistance(const FTestWidget& Start, const FTestWidget& Candidate, EUINavigation Direction, float& OutDistance) const
+		{
+			if (!Candidate.bInGrid || !Candidate.Widget->IsEnabled())
+			{
+				return false;
+			}
+
+			FSlateRect SweptRect = Start.Rect;
+			if (Direction == EUINavigation::Left || Direction == EUINavigation::Right)
+			{
+				SweptRect.Left = 0.f;
+				SweptRect.Right = GridArea.X;
+				SweptRect.Top += 0.5f;
+				SweptRect.Bottom -= 0.5f;
+			}
+			else
+			{
+				SweptRect.Top = 0.f;
+				SweptRect.Bottom = GridArea.Y;
+				SweptRect.Left += 0.5f;
+				SweptRect.Right -= 0.5f;
+			}
+			if (!FSlateRect::DoRectanglesIntersect(SweptRect, Candidate.Rect))
+			{
+				return false;
+			}
+
+			switch (Direction)
+			{
+			case EUINavigation::Left:
+				OutDistance = Start.Rect.Left - Candidate.Rect.Right;
+				break;
+			case EUINavigation::Right:
+				OutDistance = Candidate.Rect.Left - Start.Rect.Right;
+				break;
+			case EUINavigation::Up:
+				OutDistance = Start.Rect.Top - Candidate.Rect.Bottom;
+				break;
+			case EUINavigation::Down:
+				OutDistance = Candidate.Rect.Top - Start.Rect.Bottom;
+				break;
+			default:
+				return false;
+			}
+			return OutDistance > -0.1f;
+		}
+
+		FString Describe(const SWidget* Widget) const
+		{
+			if (Widget == nullptr)
+			{
+				return TEXT("nothing");
+			}
+			if (Widget == &Root.Get())
+			{
+				return TEXT("the root");
+			}
+			const int32 Index = Widgets.IndexOfByPredicate([Widget](const FTestWidget& TestWidget) { return TestWidget.Widget.Get() == Widget; });
+			return FString::Printf(TEXT("widget %d"), Index);
+		}
+
+		/** The leaf of the path and its start, which has to be the window */
+		bool TestPath(FAutomationTestBase& Test, const TCHAR* What, const FVector2D& Point, TArrayView<const FWidgetAndPointer> Path, bool bIgnoreEnabledStatus) const
+		{
+			// A disabled hit is cut from the path with its descendants
+			const FTestWidget* Expected = BruteForceHit(Point);
+			const SWidget* ExpectedLeaf = nullptr;
+			if (Expected)
+			{
+				ExpectedLeaf = bIgnoreEnabledStatus || Expected->Widget->IsEnabled() ? static_cast<const SWidget*>(Expected->Widget.Get()) : &Root.Get();
+			}
+
+			const SWidget* Leaf = Path.Num() > 0 ? &Path.Last().Widget.Get() : nullptr;
+			if (Leaf != ExpectedLeaf)
+			{
+				Test.AddError(FString::Printf(TEXT("%s at (%.2f, %.2f) hit %s, the brute force hit %s"), What, Point.X, Point.Y, *Describe(Leaf), *Describe(ExpectedLeaf)));
+				return false;
+			}
+			if (Path.Num() > 0 && &Path[0].Widget.Get() != &Window.Get())
+			{
+				Test.AddError(FString::Printf(TEXT("%s at (%.2f, %.2f) doesn't start at the window"), What, Point.X, Point.Y));
+				return false;
+			}
+			return true;
+		}
+
+		FRandomStream Random;
+
+		TSharedRef<SWindow> Window;
+
+		TSharedRef<SBorder> Root;
+
+		FHittestGrid Grid;
+
+		TSharedRef<FHittestGrid> AppendedGrid;
+
+		TArray<FTestWidget> Widgets;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMaskWidgetHittestGridBubblePathTest, "MaskWidget.HittestGrid.BubblePath", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMaskWidgetHittestGridBubblePathTest::RunTest(const FString& Parameters)
+{
+	MaskWidgetTests::FRandomLayout Layout(1337, 80);
+	for (int32 Round = 0; Round < 16; Round++)
+	{
+		Layout.Shuffle();
+
+		// Hovering: the same point again and a small move are answered by the hover cache
+		TArray<FVector2D> Points;
+		for (int32 i = 0; i < 256; i++)
+		{
+			const FVector2D Point = Layout.RandomPoint();
+			Points.Add(Point);
+			Points.Add(Point);
+			Points.Add(Point + FVector2D(Layout.Random.FRandRange(-4.f, 4.f), Layout.Random.FRandRange(-4.f, 4.f)));
+		}
+
+		for (const FVector2D& Point : Points)
+		{
+			const TArray<FWidgetAndPointer> Path = Layout.Grid.GetBubblePath(Point, 0.f, true);
+			if (!Layout.TestPath(*this, TEXT("GetBubblePath"), Point, Path, true))
+			{
+				return false;
+			}
+		}
+
+		FHittestGrid::FBubblePathBuffer PathBuffer;
+		for (const FVector2D& Point : Points)
+		{
+			Layout.Grid.GetBubblePath(Point, 0.f, false, INDEX_NONE, PathBuffer);
+			if (!Layout.TestPath(*this, TEXT("GetBubblePath of enabled widgets"), Point, PathBuffer, false))
+			{
+				return false;
+			}
+		}
+
+		TArray<TArray<FWidgetAndPointer>> Paths;
+		Layout.Grid.GetBubblePaths(Points, Paths, true);
+		for (int32 i = 0; i < Points.Num(); i++)
+		{
+			if (!Layout.TestPath(*this, TEXT("GetBubblePaths"), Points[i], Paths[i], true))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMaskWidgetHittestGridNavigationTest, "MaskWidget.HittestGrid.Navigation", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMaskWidgetHittestGridNavigationTest::RunTest(const FString& Parameters)
+{
+	using MaskWidgetTests::FTestWidget;
+
+	static const EUINavigation Directions[] = { EUINavigation::Left, EUINavigation::Right, EUINavigation::Up, EUINavigation::Down };
+
+	MaskWidgetTests::FRandomLayout Layout(4242, 80);
+	const FArrangedWidget RuleWidget(Layout.Root, Layout.Root->GetPaintSpaceGeometry());
+	for (int32 Round = 0; Round < 8; Round++)
+	{
+		Layout.Shuffle();
+
+		for (const FTestWidget& Start : Layout.Widgets)
+		{
+			if (!Start.bInGrid)
+			{
+				continue;
+			}
+
+			for (EUINavigation Direction : Directions)
+			{
+				const TSharedPtr<SWidget> Found = Layout.Grid.FindNextFocusableWidget(FArrangedWidget(Start.Widget.ToSharedRef(), Start.Widget->GetPaintSpaceGeometry()),
+					Direction, FNavigationReply::Escape(), RuleWidget, 0);
+
+				const FTestWidget* Expected = nullptr;
+				float ExpectedDistance = 0.f;
+				for (const FTestWidget& Candidate : Layout.Widgets)
+				{
+					float Distance;
+					if (&Candidate != &Start && Layout.GetNavigationDistance(Start, Candidate, Direction, Distance) && (Expected == nullptr || Distance < ExpectedDistance))
+					{
+						Expected = &Candidate;
+						ExpectedDistance = Distance;
+					}
+				}
+
+				// Edges within 0.1 of each other are equally close to the grid, either widget is right
+				const FTestWidget* FoundWidget = Layout.Widgets.FindByPredicate([&Found](const FTestWidget& TestWidget) { return TestWidget.Widget == Found; });
+				float FoundDistance = 0.f;
+				const bool bFoundValid = FoundWidget && Layout.GetNavigationDistance(Start, *FoundWidget, Direction, FoundDistance);
+				const bool bMatches = Expected == nullptr ? !Found.IsValid() : bFoundValid && FoundDistance <= ExpectedDistance + 0.1f;
+				if (!bMatches)
+				{
+					AddError(FString::Printf(TEXT("Navigating %s from %s found %s, the brute force found %s"), *UEnum::GetValueAsString(Direction),
+						*Layout.Describe(Start.Widget.Get()), *Layout.Describe(Found.Get()), *Layout.Describe(Expected ? Expected->Widget.Get() : nullptr)));
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+namespace MaskWidgetTests
+{
+	/** R of the known mask at a texel, zero blocks clicks and any other value lets them through */
+	static uint8 GetKnownMaskR(int32 X, int32 Y)
+	{
+		static const uint8 Values[] = { 0, 1, 128, 255, 0 };
+		return Values[(X * 7 + Y * 3) % UE_ARRAY_COUNT(Values)];
+	}
+
+	/** BGRA8 texture of the known mask, the other channels are opaque white so only R decides */
+	static UTexture2D* CreateKnownMaskTexture(int32 SizeX, int32 SizeY)
+	{
+		UTexture2D* Texture = UTexture2D::CreateTransient(SizeX, SizeY, PF_B8G8R8A8);
+		FByteBulkData& BulkData = Texture->PlatformData->Mips[0].BulkData;
+		uint8* Texels = static_cast<uint8*>(BulkData.Lock(LOCK_READ_WRITE));
+		for (int32 Y = 0; Y < SizeY; Y++)
+		{
+			for (int32 X = 0; X < SizeX; X++)
+			{
+				uint8* Texel = &Texels[(Y * SizeX + X) * 4];
+				Texel[0] = 255;
+				Texel[1] = 255;
+				Texel[2] = GetKnownMaskR(X, Y);
+				Texel[3] = 255;
+			}
+		}
+		BulkData.Unlock();
+		return Texture;
+	}
+
+	/** Every texel center of Bitmap against the known mask */
+	static bool TestKnownMask(FAutomationTestBase& Test, const FMaskHitTestBitmap& Bitmap)
+	{
+		for (int32 Y = 0; Y < Bitmap.GetSizeY(); Y++)
+		{
+			for (int32 X = 0; X < Bitmap.GetSizeX(); X++)
+			{
+				const FVector2D UV((X + 0.5f) / Bitmap.GetSizeX(), (Y + 0.5f) / Bitmap.GetSizeY());
+				if (Bitmap.IsClickThrough(UV) != (GetKnownMaskR(X, Y) > 0))
+				{
+					Test.AddError(FString::Printf(TEXT("Texel (%d, %d) of the %dx%d bitmap doesn't match the known mask"), X, Y, Bitmap.GetSizeX(), Bitmap.GetSizeY()));
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMaskWidgetHitTestBitmapTest, "MaskWidget.HitTestBitmap", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMaskWidgetHitTestBitmapTest::RunTest(const FString& Parameters)
+{
+	// Rows that don't end on a word boundary
+	const int32 SizeX = 37;
+	const int32 SizeY = 13;
+	UTexture2D* Texture = MaskWidgetTests::CreateKnownMaskTexture(SizeX, SizeY);
+
+	const TSharedPtr<const FMaskHitTestBitmap> Bitmap = FMaskHitTestBitmap::FindOrBuild(Texture);
+	if (!TestTrue(TEXT("Bitmap built from BGRA8 mips"), Bitmap.IsValid()))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Bitmap width"), Bitmap->GetSizeX(), SizeX);
+	TestEqual(TEXT("Bitmap height"), Bitmap->GetSizeY(), SizeY);
+	TestTrue(TEXT("Bitmap built from the texture"), Bitmap->IsBuiltFrom(Texture));
+	TestTrue(TEXT("Find returns the cached bitmap"), FMaskHitTestBitmap::Find(Texture) == Bitmap.Get());
+	if (!MaskWidgetTests::TestKnownMask(*this, *Bitmap))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("UV (1, 1) is the last texel"), Bitmap->IsClickThrough(FVector2D(1.f, 1.f)), MaskWidgetTests::GetKnownMaskR(SizeX - 1, SizeY - 1) > 0);
+	TestEqual(TEXT("UV (0, 0) is the first texel"), Bitmap->IsClickThrough(FVector2D(0.f, 0.f)), MaskWidgetTests::GetKnownMaskR(0, 0) > 0);
+	TestFalse(TEXT("Left of the mask"), Bitmap->IsClickThrough(FVector2D(-0.01f, 0.5f)));
+	TestFalse(TEXT("Below the mask"), Bitmap->IsClickThrough(FVector2D(0.5f, 1.01f)));
+
+	// New art, the cached bitmap is rebuilt in place
+	FByteBulkData& BulkData = Texture->PlatformData->Mips[0].BulkData;
+	uint8* Texels = static_cast<uint8*>(BulkData.Lock(LOCK_READ_WRITE));
+	for (int32 Index = 0; Index < SizeX * SizeY; Index++)
+	{
+		Texels[Index * 4 + 2] = 255;
+	}
+	BulkData.Unlock();
+	FMaskHitTestBitmap::Invalidate(Texture);
+	const FMaskHitTestBitmap* Rebuilt = FMaskHitTestBitmap::Find(Texture);
+	TestTrue(TEXT("Invalidate rebuilds a cached bitmap"), Rebuilt != nullptr && Rebuilt->IsClickThrough(FVector2D(0.f, 0.f)));
+
+	// Block-compressed mips without a sidecar can't be read, cached as null so they are reported once
+	UTexture2D* Compressed = UTexture2D::CreateTransient(8, 8, PF_DXT1);
+	AddExpectedError(TEXT("can't be read back"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestFalse(TEXT("No bitmap from DXT1 mips"), FMaskHitTestBitmap::FindOrBuild(Compressed).IsValid());
+	TestFalse(TEXT("No bitmap from DXT1 mips, cached"), FMaskHitTestBitmap::FindOrBuild(Compressed).IsValid());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMaskWidgetHitTestSidecarTest, "MaskWidget.HitTestSidecar", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMaskWidgetHitTestSidecarTest::RunTest(const FString& Parameters)
+{
+	// The sidecar of a compressed texture, at source resolution rather than the resolution of the mips
+	const int32 SizeX = 45;
+	const int32 SizeY = 16;
+	UTexture2D* Compressed = UTexture2D::CreateTransient(8, 8, PF_DXT1);
+	UMaskHitTestUserData* Sidecar = NewObject<UMaskHitTestUserData>(Compressed);
+	Sidecar->SizeX = SizeX;
+	Sidecar->SizeY = SizeY;
+	Sidecar->Bits.SetNumZeroed(FMath::DivideAndRoundUp(SizeX * SizeY, 32));
+	for (int32 Y = 0; Y < SizeY; Y++)
+	{
+		for (int32 X = 0; X < SizeX; X++)
+		{
+			if (MaskWidgetTests::GetKnownMaskR(X, Y) > 0)
+			{
+				const int32 Index = Y * SizeX + X;
+				Sidecar->Bits[Index >> 5] |= 1u << (Index & 31);
+			}
+		}
+	}
+	TestTrue(TEXT("Sidecar data is valid"), Sidecar->IsValidData());
+	Compressed->AddAssetUserData(Sidecar);
+	TestTrue(TEXT("Find returns the sidecar"), UMaskHitTestUserData::Find(Compressed) == Sidecar);
+
+	const TSharedPtr<const FMaskHitTestBitmap> Bitmap = FMaskHitTestBitmap::FindOrBuild(Compressed);
+	if (!TestTrue(TEXT("Bitmap built from the sidecar of DXT1 mips"), Bitmap.IsValid()))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Bitmap width"), Bitmap->GetSizeX(), SizeX);
+	TestEqual(TEXT("Bitmap height"), Bitmap->GetSizeY(), SizeY);
+	return MaskWidgetTests::TestKnownMask(*this, *Bitmap);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMaskWidgetClipShapeTest, "MaskWidget.ClipShape.IsInside", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMaskWidgetClipShapeTest::RunTest(const FString& Parameters)
+{
+	struct FKnownPoint
+	{
+		const TCHAR* What;
+		FVector2D UV;
+		bool bInside;
+	};
+
+	auto TestShape = [this](const TCHAR* ShapeName, const FMaskClipShape& Shape, const FVector2D& ClipSize, TArrayView<const FKnownPoint> Points)
+	{
+		for (const FKnownPoint& Point : Points)
+		{
+			TestEqual(FString::Printf(TEXT("%s: %s"), ShapeName, Point.What), Shape.IsInside(Point.UV, ClipSize), Point.bInside);
+		}
+	};
+
+	// Without MaskTex a Texture clip is hit tested as the ellipse
+	const FKnownPoint EllipsePoints[] = {
+		{ TEXT("center"), FVector2D(0.5f, 0.5f), true },
+		{ TEXT("near the top"), FVector2D(0.5f, 0.02f), true },
+		{ TEXT("on the top"), FVector2D(0.5f, 0.f), false },
+		{ TEXT("corner"), FVector2D(0.05f, 0.05f), false },
+	};
+	FMaskClipShape Shape;
+	TestShape(TEXT("Texture"), Shape, FVector2D(100.f, 50.f), EllipsePoints);
+	Shape.Type = EMaskClipShapeType::Ellipse;
+	TestShape(TEXT("Ellipse"), Shape, FVector2D(100.f, 50.f), EllipsePoints);
+
+	Shape.Type = EMaskClipShapeType::RoundedRect;
+	const FKnownPoint RectPoints[] = {
+		{ TEXT("corner"), FVector2D(0.01f, 0.02f), true },
+		{ TEXT("right edge"), FVector2D(0.999f, 0.5f), true },
+		{ TEXT("past the right edge"), FVector2D(1.01f, 0.5f), false },
+	};
+	TestShape(TEXT("RoundedRect without radius"), Shape, FVector2D(100.f, 50.f), RectPoints);
+
+	// 100x50 with a radius of 20, the corner circle is centered on (20, 20)
+	Shape.CornerRadius = 20.f;
+	const FKnownPoint RoundedPoints[] = {
+		{ TEXT("cut corner"), FVector2D(0.01f, 0.02f), false },
+		{ TEXT("corner circle center"), FVector2D(0.2f, 0.4f), true },
+		{ TEXT("inside the corner arc"), FVector2D(0.07f, 0.14f), true },
+		{ TEXT("top edge past the arc"), FVector2D(0.5f, 0.01f), true },
+	};
+	TestShape(TEXT("RoundedRect"), Shape, FVector2D(100.f, 50.f), RoundedPoints);
+
+	// The radius is clamped to half the shorter side, a capsule
+	Shape.CornerRadius = 1000.f;
+	const FKnownPoint CapsulePoints[] = {
+		{ TEXT("left end"), FVector2D(0.02f, 0.5f), true },
+		{ TEXT("left end corner"), FVector2D(0.01f, 0.05f), false },
+		{ TEXT("middle of the top edge"), FVector2D(0.5f, 0.01f), true },
+	};
+	TestShape(TEXT("Capsule"), Shape, FVector2D(100.f, 50.f), CapsulePoints);
+
+	Shape.Type = EMaskClipShapeType::Polygon;
+	Shape.CornerRadius = 0.f;
+	Shape.Points = { FVector2D(0.f, 0.f), FVector2D(1.f, 0.f), FVector2D(0.f, 1.f) };
+	const FKnownPoint TrianglePoints[] = {
+		{ TEXT("inside"), FVector2D(0.2f, 0.2f), true },
+		{ TEXT("past the diagonal"), FVector2D(0.6f, 0.6f), false },
+		{ TEXT("on an edge"), FVector2D(0.5f, 0.f), false },
+	};
+	TestShape(TEXT("Triangle"), Shape, FVector2D(80.f, 40.f), TrianglePoints);
+	Algo::Reverse(Shape.Points);
+	TestShape(TEXT("Triangle, other winding"), Shape, FVector2D(80.f, 40.f), TrianglePoints);
+
+	const FKnownPoint CenterPoint[] = { { TEXT("center"), FVector2D(0.5f, 0.5f), false } };
+	Shape.Points = { FVector2D(0.f, 0.f), FVector2D(1.f, 1.f) };
+	TestShape(TEXT("Polygon of two points"), Shape, FVector2D(80.f, 40.f), CenterPoint);
+	Shape.Points = { FVector2D(0.f, 0.f), FVector2D(0.5f, 0.5f), FVector2D(1.f, 1.f) };
+	TestShape(TEXT("Collinear polygon"), Shape, FVector2D(80.f, 40.f), CenterPoint);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMaskWidgetSetMaskClipsTest, "MaskWidget.Style.SetMaskClips", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMaskWidgetSetMaskClipsTest::RunTest(const FString& Parameters)
+{
+	FMaskWidgetStyle Style;
+	Style.MaxClipCount = 4;
+
+	TArray<FMaskClipDesc> Clips;
+	for (int32 i = 0; i < 3; i++)
+	{
+		FMaskClipDesc& Clip = Clips.AddDefaulted_GetRef();
+		Clip.Position = FVector2D(100.f * i, 50.f);
+		Clip.Size = FVector2D(64.f, 32.f);
+		Clip.ClipEnable = true;
+		Clip.Shape.Type = EMaskClipShapeType::Ellipse;
+	}
+	TestTrue(TEXT("SetMaskClips"), Style.SetMaskClips(Clips));
+
+	// What OnPaint does once the flags are pushed to the material
+	FMaskClipPaintArray PaintClips;
+	auto GatherAndClear = [&Style, &PaintClips]()
+	{
+		Style.GatherPaintData(PaintClips);
+		TArray<EMaskClipDirty> Flags;
+		for (FMaskClipPaintData& Clip : PaintClips)
+		{
+			Flags.Add(Clip.DirtyFlags);
+			Clip.DirtyFlags = EMaskClipDirty::None;
+		}
+		return Flags;
+	};
+
+	TArray<EMaskClipDirty> Flags = GatherAndClear();
+	if (!TestEqual(TEXT("Gathered clips"), PaintClips.Num(), 3))
+	{
+		return false;
+	}
+	for (int32 i = 0; i < 3; i++)
+	{
+		TestTrue(FString::Printf(TEXT("New clip %d is pushed entirely"), i), Flags[i] == EMaskClipDirty::All);
+		TestTrue(FString::Printf(TEXT("Position of clip %d"), i), PaintClips[i].Position == Clips[i].Position);
+	}
+
+	TestTrue(TEXT("SetMaskClips without changes"), Style.SetMaskClips(Clips));
+	Flags = GatherAndClear();
+	TestTrue(TEXT("Unchanged clips aren't pushed again"), Flags.Num() == 3 && Flags[0] == EMaskClipDirty::None && Flags[1] == EMaskClipDirty::None && Flags[2] == EMaskClipDirty::None);
+
+	Clips[1].Position.X += 10.f;
+	Clips[2].ClipEnable = false;
+	TestTrue(TEXT("SetMaskClips with changes"), Style.SetMaskClips(Clips));
+	Flags = GatherAndClear();
+	TestTrue(TEXT("Untouched clip"), Flags[0] == EMaskClipDirty::None);
+	TestTrue(TEXT("Moved clip"), Flags[1] == EMaskClipDirty::Geometry);
+	TestTrue(TEXT("Disabled clip"), Flags[2] == EMaskClipDirty::Enable);
+	TestFalse(TEXT("Disabled clip is gathered disabled"), PaintClips[2].bEnabled);
+
+	Clips.Pop();
+	TestTrue(TEXT("SetMaskClips with a clip less"), Style.SetMaskClips(Clips));
+	GatherAndClear();
+	TestEqual(TEXT("Gathered clips after a removal"), PaintClips.Num(), 2);
+
+	Clips.SetNum(Style.MaxClipCount + 1);
+	AddExpectedError(TEXT("too many clips"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestFalse(TEXT("SetMaskClips past MaxClipCount"), Style.SetMaskClips(Clips));
+	TestEqual(TEXT("Clips are kept when SetMaskClips fails"), Style.MaskClips.Num(), 2);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
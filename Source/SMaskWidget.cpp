@@ -1,215 +1,589 @@
-#include "SMaskWidget.h"
-#include "HittestGrid.h"
-#include "Engine/Texture2D.h"
-#include "Rendering/DrawElements.h"
-#include "Layout/SlateClickClippingState.h"
-
-void SMaskWidget::Construct(const FArguments& InArgs)
-{
-	check(InArgs._Style);
-	BgColorAndOpacity = InArgs._BgColorAndOpacity;
-	Style = const_cast<FMaskWidgetStyle*>(InArgs._Style);
-
-	SetCanTick(false);
-}
-
-void SMaskWidget::SetBgColorAndOpacity(const TAttribute<FSlateColor>& InColorAndOpacity)
-{
-	SetAttribute(BgColorAndOpacity, InColorAndOpacity, EInvalidateWidgetReason::Paint);
-}
-
-void SMaskWidget::SetBgColorAndOpacity(FLinearColor InColorAndOpacity)
-{
-	SetBgColorAndOpacity(TAttribute<FSlateColor>(InColorAndOpacity));
-}
-
-void SMaskWidget::SetStyle(const FMaskWidgetStyle* InStyle)
-{
-	if (InStyle == nullptr)
-	{
-		FArguments Defaults;
-		Style = const_cast<FMaskWidgetStyle*>(Defaults._Style);
-	}
-	else
-	{
-		Style = const_cast<FMaskWidgetStyle*>(InStyle);
-	}
-
-	check(Style);
-
-	Invalidate(EInvalidateWidget::Layout);
-	
-	IsMaskUpdated = true;
-}
-
-void SMaskWidget::SetMaskPosition(const int32& ClipIndex, TAttribute<FVector2D> InMaskPosition)
-{
-	if (Style->SetMaskPos(ClipIndex, InMaskPosition.Get()))
-	{
-		IsMaskUpdated = true;
-		Invalidate(EInvalidateWidget::Layout);
-	}
-}
-
-void SMaskWidget::SetBackgroundImage(const FSlateBrush* InBackgroundImage)
-{
-	if (BackgroundImage != InBackgroundImage)
-	{
-		IsMaskUpdated = true;
-		BackgroundImage = InBackgroundImage;
-		Invalidate(EInvalidateWidget::Layout);
-	}
-}
-
-const FSlateBrush* SMaskWidget::GetBackgroundImage() const
-{
-	return BackgroundImage ? BackgroundImage : &Style->BackgroundImage;
-}
-
-const UTexture2D* SMaskWidget::GetMaskTextureByIndex(const int32& Index) const
-{
-	return Style->GetMaskTextureByIdx(Index);
-}
-
-const FSlateBrush* SMaskWidget::GetMaskMatBrush() const
-{
-	return &Style->MaskMatBrush;
-}
-
-void SMaskWidget::ReIndexClip()
-{
-	Style->ReIndexClip();
-}
-
-bool SMaskWidget::IsInteractable() const
-{
-	return IsEnabled();
-}
-
-int32 SMaskWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
-{
-	int32 RetLayerId = LayerId;
-	SMaskWidget* MutableThis = const_cast<SMaskWidget*>(this);
-
-	const FSlateBrush* CurBgImage = GetBackgroundImage();
-	const FSlateBrush* MatBrush = GetMaskMatBrush();
-
-#if !WITH_EDITOR
-	if (MutableThis->IsMaskUpdated)
-	{
-#endif
-		if (UMaterialInstanceDynamic* DyMat = Cast<UMaterialInstanceDynamic>(MatBrush->GetResourceObject()))
-		{
-			FVector2D GSize = AllottedGeometry.GetLocalSize();
-			const TArray<FMaskClip> Clips = Style->MaskClips;
-			for (uint8 i = 0; i < MAX_MASK_CLIP_COUNT; i++)
-			{
-				if (i < Clips.Num())
-				{
-					FMaskClip Clip = Clips[i];
-					FVector2D Size = Clip.GetSize();
-					FVector2D Pos = Clip.GetPos();
-					DyMat->SetVectorParameterValue(*FString::Printf(TEXT("MaskUV_%d"), i), FLinearColor(Pos.X / GSize.X, Pos.Y / GSize.Y, Size.X / GSize.X, Size.Y / GSize.Y));
-					if (UTexture2D* Tex = Clip.GetMaskTexture())
-					{
-						DyMat->SetTextureParameterValue(*FString::Printf(TEXT("MaskTex_%d"), i), Tex);
-					}
-				}
-				else
-				{
-					DyMat->SetVectorParameterValue(*FString::Printf(TEXT("MaskUV_%d"), i), FLinearColor(0.f, 0.f, 0.f, 0.f));
-				}
-			}
-			DyMat->SetTextureParameterValue("BgTex", Cast<UTexture>(CurBgImage->GetResourceObject()));
-		}
-
-#if !WITH_EDITOR
-		MutableThis->IsMaskUpdated = false;
-	}
-#endif
-
-	FSlateDrawElement::MakeBox(
-		OutDrawElements,
-		RetLayerId++,
-		AllottedGeometry.ToPaintGeometry(),
-		MatBrush,
-		ESlateDrawEffect::None,
-		InWidgetStyle.GetColorAndOpacityTint() *
-		BgColorAndOpacity.Get().GetColor(InWidgetStyle) * CurBgImage->GetTint(InWidgetStyle)
-	);
-
-	FSlateLayoutTransform TranLayout(AllottedGeometry.Scale, AllottedGeometry.AbsolutePosition);
-	const TArray<FMaskClip> Clips = Style->MaskClips;
-	for (uint8 i = 0; i < MAX_MASK_CLIP_COUNT && i < Clips.Num(); i++)
-	{
-		if (Clips[i].IsEnable())
-		{
-			FGeometry MaskGeometry = AllottedGeometry.MakeChild(Clips[i].GetPos(), Clips[i].GetSize(), 1.f);
-			Args.GetHittestGrid().AddClickClip(this, MakeShareable(new FSlateClickClippingState(i, MaskGeometry, FOnClickClipClicked::CreateRaw(MutableThis, &SMaskWidget::OnClickClipClicked))));
-		}
-	}
-
-	return RetLayerId;
-}
-
-bool SMaskWidget::OnClickClipClicked(const FVector2D& HitUVInMask, const int32& ClipIndex)
-{
-	bool bThroughMask = false;
-
-	if (const UTexture2D* MaskTexture = GetMaskTextureByIndex(ClipIndex))
-	{
-		int32 SizeX = MaskTexture->GetSizeX();
-		int32 SizeY = MaskTexture->GetSizeY();
-		int32 BufferLen = SizeX * SizeY;
-		int32 BufferIdx = floor(HitUVInMask.Y * SizeY) * SizeX + floor(HitUVInMask.X * SizeX);
-		if (const FColor* MaskData = reinterpret_cast<const FColor*>(MaskTexture->PlatformData->Mips[0].BulkData.LockReadOnly()))
-		{
-			if (BufferIdx >= 0 && BufferIdx < BufferLen)
-			{
-				if (MaskData[BufferIdx].R > 0)
-				{
-					bThroughMask = true;
-				}
-			}
-		}
-		MaskTexture->PlatformData->Mips[0].BulkData.Unlock();
-	}
-	else
-	{
-		bThroughMask = FVector2D::DistSquared(HitUVInMask - 0.5f, FVector2D::ZeroVector) < 0.25f;
-	}
-
-// 移动设备没有Hover，此时触发可以认为是OnClick
-// 触发OnClicked是为了给用户一个比较方便的方法处理MaskWidget被点击了
-#if PLATFORM_IOS || PLATFORM_ANDROID
-	if (OnClicked.IsBound())
-	{
-		OnClicked.Execute(ClipIndex, bThroughMask);
-	}
-#endif
-
-	return bThroughMask;
-}
-
-FVector2D SMaskWidget::ComputeDesiredSize(float) const
-{
-	return GetBackgroundImage()->ImageSize;
-}
-
-FReply SMaskWidget::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
-{
-	if (OnClicked.IsBound())
-	{
-		return OnClicked.Execute(-1, false);
-	}
-	return FReply::Handled();
-}
-
-FReply SMaskWidget::OnTouchGesture(const FGeometry& MyGeometry, const FPointerEvent& GestureEvent)
-{
-	if (OnClicked.IsBound())
-	{
-		return OnClicked.Execute(-1, false);
-	}
-	return FReply::Handled();
-}
+#include "SMaskWidget.h"
+#include "HittestGrid.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/Texture2D.h"
+#include "Rendering/DrawElements.h"
+#include "Layout/SlateClickClippingState.h"
+#include "MaskClipRenderData.h"
+#include "MaskMaterialParameters.h"
+#include "MaskMaterialPool.h"
+
+DEFINE_STAT(STAT_MaskWidgetPaintAllocations);
+
+void SMaskWidget::Construct(const FArguments& InArgs)
+{
+	check(InArgs._Style);
+	BgColorAndOpacity = InArgs._BgColorAndOpacity;
+	Style = const_cast<FMaskWidgetStyle*>(InArgs._Style);
+	DesiredImageSize = GetBackgroundImage()->ImageSize;
+	Style->BuildHitTestBitmaps();
+
+	SetCanTick(false);
+}
+
+SMaskWidget::~SMaskWidget()
+{
+	FMaskMaterialPool& Pool = FMaskMaterialPool::Get();
+	Pool.OnMaskMaterialLoaded().Remove(MaskMaterialLoadedHandle);
+	Pool.Release(Cast<UMaterialInstanceDynamic>(MaskMatBrush.GetResourceObject()));
+
+	// Textures other widgets still use stay loaded through their own handles
+	for (const TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& Pair : MaskTextureHandles)
+	{
+		Pair.Value->CancelHandle();
+	}
+}
+
+void SMaskWidget::SetBgColorAndOpacity(const TAttribute<FSlateColor>& InColorAndOpacity)
+{
+	SetAttribute(BgColorAndOpacity, InColorAndOpacity, EInvalidateWidgetReason::Paint);
+}
+
+void SMaskWidget::SetBgColorAndOpacity(FLinearColor InColorAndOpacity)
+{
+	SetBgColorAndOpacity(TAttribute<FSlateColor>(InColorAndOpacity));
+}
+
+void SMaskWidget::SetStyle(const FMaskWidgetStyle* InStyle, EInvalidateWidgetReason InvalidateReason)
+{
+	const FMaskWidgetStyle* PreviousStyle = Style;
+
+	if (InStyle == nullptr)
+	{
+		FArguments Defaults;
+		Style = const_cast<FMaskWidgetStyle*>(Defaults._Style);
+	}
+	else
+	{
+		Style = const_cast<FMaskWidgetStyle*>(InStyle);
+	}
+
+	check(Style);
+
+	if (Style != PreviousStyle)
+	{
+		// The material has the previous style's clips, other widgets of the style are up to date
+		MarkPaintClipsDirty(EMaskClipDirty::All);
+	}
+
+	// The clips and their ClickClips are pushed on paint, the parents only need a prepass when the desired size changed
+	Invalidate(InvalidateReason | GetDesiredSizeInvalidateReason());
+	
+	IsMaskUpdated = true;
+}
+
+void SMaskWidget::SetMaskPosition(const int32& ClipIndex, TAttribute<FVector2D> InMaskPosition)
+{
+	if (Style->SetMaskPos(ClipIndex, InMaskPosition.Get()))
+	{
+		IsMaskUpdated = true;
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+}
+
+void SMaskWidget::SetBackgroundImage(const FSlateBrush* InBackgroundImage)
+{
+	if (BackgroundImage != InBackgroundImage)
+	{
+		IsMaskUpdated = true;
+		BackgroundImage = InBackgroundImage;
+		Invalidate(GetDesiredSizeInvalidateReason());
+	}
+}
+
+EInvalidateWidgetReason SMaskWidget::GetDesiredSizeInvalidateReason()
+{
+	// ComputeDesiredSize only depends on the background ImageSize
+	const FVector2D ImageSize = GetBackgroundImage()->ImageSize;
+	if (ImageSize != DesiredImageSize)
+	{
+		DesiredImageSize = ImageSize;
+		return EInvalidateWidgetReason::Layout;
+	}
+	return EInvalidateWidgetReason::Paint;
+}
+
+const FSlateBrush* SMaskWidget::GetBackgroundImage() const
+{
+	return BackgroundImage ? BackgroundImage : &Style->BackgroundImage;
+}
+
+const UTexture2D* SMaskWidget::GetMaskTextureByIndex(const int32& Index) const
+{
+	return Style->GetMaskTextureByIdx(Index);
+}
+
+const FMaskHitTestBitmap* SMaskWidget::GetHitTestBitmapByIndex(const int32& Index) const
+{
+	return Style->GetHitTestBitmapByIdx(Index);
+}
+
+const FSlateBrush* SMaskWidget::GetMaskMatBrush() const
+{
+	if (MaskMatBrush.GetResourceObject() == nullptr)
+	{
+		// Widgets that are never painted (templates, designer previews) never create an instance
+		SMaskWidget* MutableThis = const_cast<SMaskWidget*>(this);
+		FMaskMaterialPool& Pool = FMaskMaterialPool::Get();
+		if (UMaterialInstanceDynamic* DyMat = Pool.Acquire())
+		{
+			MutableThis->MaskMatBrush.SetResourceObject(DyMat);
+		}
+		else if (!MaskMaterialLoadedHandle.IsValid())
+		{
+			// Still streaming, paint again once it is in
+			MutableThis->MaskMaterialLoadedHandle = Pool.OnMaskMaterialLoaded().AddSP(MutableThis, &SMaskWidget::OnMaskAssetsLoaded);
+		}
+	}
+	return &MaskMatBrush;
+}
+
+void SMaskWidget::RequestMaskTextures()
+{
+	// Textures of replaced clips would otherwise stay loaded as long as the widget
+	ReleaseUnusedMaskTextures();
+
+	TArray<FSoftObjectPath> PendingPaths;
+	Style->GetPendingMaskTextures(PendingPaths);
+	for (const FSoftObjectPath& Path : PendingPaths)
+	{
+		if (MaskTextureHandles.Contains(Path))
+		{
+			continue;
+		}
+
+		// One handle per path, released on its own when its clips stop using it
+		TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Path,
+			FStreamableDelegate::CreateSP(this, &SMaskWidget::OnMaskAssetsLoaded));
+		if (Handle.IsValid())
+		{
+			MaskTextureHandles.Add(Path, Handle);
+		}
+		else
+		{
+			UE_LOG(LogInit, Error, TEXT("ERROR: SMaskWidget can't stream mask texture %s"), *Path.ToString());
+		}
+	}
+}
+
+void SMaskWidget::ReleaseUnusedMaskTextures()
+{
+	if (MaskTextureHandles.Num() == 0)
+	{
+		return;
+	}
+
+	TSet<FSoftObjectPath> UsedPaths;
+	for (const FMaskClip& Clip : Style->MaskClips)
+	{
+		if (!Clip.GetSoftMaskTexture().IsNull())
+		{
+			UsedPaths.Add(Clip.GetSoftMaskTexture().ToSoftObjectPath());
+		}
+	}
+
+	for (auto It = MaskTextureHandles.CreateIterator(); It; ++It)
+	{
+		if (!UsedPaths.Contains(It->Key))
+		{
+			// Still streaming or loaded, it isn't waited for either way
+			It->Value->CancelHandle();
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void SMaskWidget::OnMaskAssetsLoaded()
+{
+	// Pending clips were painted without a cutout, regather them with their texture
+	ReleaseUnusedMaskTextures();
+	Style->BuildHitTestBitmaps();
+	MarkPaintClipsDirty(EMaskClipDirty::Texture | EMaskClipDirty::Geometry);
+	IsMaskUpdated = true;
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SMaskWidget::ReIndexClip()
+{
+	Style->ReIndexClip();
+}
+
+void SMaskWidget::AnimateClip(int32 ClipIndex, const FVector2D& TargetPosition, const FVector2D& TargetSize, float Duration, EEaseMode EaseMode)
+{
+	if (ClipIndex < 0 || ClipIndex >= Style->MaskClips.Num())
+	{
+		UE_LOG(LogInit, Error, TEXT("ERROR: SMaskWidget::AnimateClip invalid ClipIndex = %d, MaskClips.Num() = %d"), ClipIndex, Style->MaskClips.Num());
+		return;
+	}
+
+	StopClipAnimation(ClipIndex);
+
+	if (Duration <= 0.f)
+	{
+		if (Style->SetMaskPosSize(ClipIndex, FVector4(TargetPosition.X, TargetPosition.Y, TargetSize.X, TargetSize.Y)))
+		{
+			IsMaskUpdated = true;
+			Invalidate(EInvalidateWidgetReason::Paint);
+		}
+		return;
+	}
+
+	const FMaskClip& Clip = Style->MaskClips[ClipIndex];
+	ClipAnimations.Add({ ClipIndex, Clip.GetPos(), Clip.GetSize(), TargetPosition, TargetSize, Duration, 0.f, EaseMode });
+
+	if (!ClipAnimationTimer.IsValid())
+	{
+		ClipAnimationTimer = RegisterActiveTimer(0.f, FWidgetActiveTimerDelegate::CreateSP(this, &SMaskWidget::UpdateClipAnimations));
+	}
+}
+
+void SMaskWidget::StopClipAnimation(int32 ClipIndex)
+{
+	ClipAnimations.RemoveAllSwap([ClipIndex](const FClipAnimation& Animation) { return Animation.ClipIndex == ClipIndex; });
+}
+
+bool SMaskWidget::IsClipAnimating(int32 ClipIndex) const
+{
+	return ClipAnimations.ContainsByPredicate([ClipIndex](const FClipAnimation& Animation) { return Animation.ClipIndex == ClipIndex; });
+}
+
+void SMaskWidget::OnClipRemoved(int32 ClipIndex)
+{
+	StopClipAnimation(ClipIndex);
+	for (FClipAnimation& Animation : ClipAnimations)
+	{
+		if (Animation.ClipIndex > ClipIndex)
+		{
+			Animation.ClipIndex--;
+		}
+	}
+}
+
+EActiveTimerReturnType SMaskWidget::WaitForAtlasTiles(double InCurrentTime, float InDeltaTime)
+{
+	if (ClipRenderData.IsValid())
+	{
+		for (int32 i = 0; i < PaintClips.Num(); i++)
+		{
+			if (ClipRenderData->IsAtlasTilePending(i, PaintClips[i].Texture))
+			{
+				return EActiveTimerReturnType::Continue;
+			}
+		}
+	}
+
+	// The clips kept their Texture flag, the next paint writes their AtlasUV
+	IsMaskUpdated = true;
+	Invalidate(EInvalidateWidgetReason::Paint);
+	AtlasTileTimer.Reset();
+	return EActiveTimerReturnType::Stop;
+}
+
+EActiveTimerReturnType SMaskWidget::UpdateClipAnimations(double InCurrentTime, float InDeltaTime)
+{
+	bool bMoved = false;
+	for (int32 i = ClipAnimations.Num() - 1; i >= 0; i--)
+	{
+		FClipAnimation& Animation = ClipAnimations[i];
+		Animation.Elapsed = FMath::Min(Animation.Elapsed + InDeltaTime, Animation.Duration);
+
+		const float Alpha = EvaluateEase(Animation.EaseMode, Animation.Elapsed / Animation.Duration);
+		const FVector2D Position = FMath::Lerp(Animation.StartPosition, Animation.TargetPosition, Alpha);
+		const FVector2D Size = FMath::Lerp(Animation.StartSize, Animation.TargetSize, Alpha);
+
+		// Only marks the clip's geometry dirty, the next paint pushes that clip alone
+		const bool bClipExists = Style->SetMaskPosSize(Animation.ClipIndex, FVector4(Position.X, Position.Y, Size.X, Size.Y));
+		bMoved |= bClipExists;
+
+		if (!bClipExists || Animation.Elapsed >= Animation.Duration)
+		{
+			ClipAnimations.RemoveAtSwap(i);
+		}
+	}
+
+	if (bMoved)
+	{
+		IsMaskUpdated = true;
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+
+	if (ClipAnimations.Num() == 0)
+	{
+		ClipAnimationTimer.Reset();
+		return EActiveTimerReturnType::Stop;
+	}
+	return EActiveTimerReturnType::Continue;
+}
+
+float SMaskWidget::EvaluateEase(EEaseMode EaseMode, float Alpha)
+{
+	switch (EaseMode)
+	{
+	case EEaseMode::QuadEaseIn:
+		return Alpha * Alpha;
+	case EEaseMode::QuadEaseOut:
+		return 1.f - FMath::Square(1.f - Alpha);
+	case EEaseMode::CubicEaseIn:
+		return Alpha * Alpha * Alpha;
+	case EEaseMode::CubicEaseOut:
+		return 1.f - (1.f - Alpha) * (1.f - Alpha) * (1.f - Alpha);
+	case EEaseMode::LinearIn:
+	default:
+		return Alpha;
+	}
+}
+
+bool SMaskWidget::IsInteractable() const
+{
+	return IsEnabled();
+}
+
+void SMaskWidget::MarkPaintClipsDirty(EMaskClipDirty Flags)
+{
+	for (FMaskClipPaintData& Clip : PaintClips)
+	{
+		Clip.DirtyFlags |= Flags;
+	}
+}
+
+int32 SMaskWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	int32 RetLayerId = LayerId;
+	SMaskWidget* MutableThis = const_cast<SMaskWidget*>(this);
+
+	const FSlateBrush* CurBgImage = GetBackgroundImage();
+	const FSlateBrush* MatBrush = GetMaskMatBrush();
+
+	FMaskClipPaintArray& PaintClips = MutableThis->PaintClips;
+	bool bPushClips = false;
+	if (IsMaskUpdated)
+	{
+		const int32 PreviousMax = PaintClips.Max();
+		Style->GatherPaintData(PaintClips);
+		if (PaintClips.Max() != PreviousMax)
+		{
+			INC_DWORD_STAT(STAT_MaskWidgetPaintAllocations);
+		}
+		MutableThis->IsMaskUpdated = false;
+		bPushClips = true;
+
+		for (const FMaskClipPaintData& Clip : PaintClips)
+		{
+			if (Clip.bPending)
+			{
+				MutableThis->RequestMaskTextures();
+				break;
+			}
+		}
+	}
+
+	// Clips the material draws, the others get no ClickClip
+	int32 DrawnClipCount = 0;
+	// Legacy materials only draw MaskTex_%d, analytic clips are neither drawn nor clickable with them
+	bool bDrawsAnalyticShapes = false;
+	if (UMaterialInstanceDynamic* DyMat = Cast<UMaterialInstanceDynamic>(MatBrush->GetResourceObject()))
+	{
+		FMaskMaterialParameters& Parameters = MutableThis->MaterialParameters;
+		const FVector2D GSize = AllottedGeometry.GetLocalSize();
+		if (Parameters.Bind(DyMat))
+		{
+			// A new instance has none of our values
+			MutableThis->MarkPaintClipsDirty(EMaskClipDirty::All);
+			MutableThis->PaintedBgTex.Reset();
+			MutableThis->PaintedClipCount = LEGACY_MASK_CLIP_COUNT;
+			bPushClips = true;
+		}
+		if (GSize != PaintedGeometrySize)
+		{
+			// MaskUV is normalized to the widget
+			MutableThis->MarkPaintClipsDirty(EMaskClipDirty::Geometry);
+			MutableThis->PaintedGeometrySize = GSize;
+			bPushClips = true;
+		}
+
+		if (bPushClips)
+		{
+			if (Parameters.SupportsClipData())
+			{
+				if (!ClipRenderData.IsValid())
+				{
+					MutableThis->ClipRenderData = MakeUnique<FMaskClipRenderData>();
+					INC_DWORD_STAT(STAT_MaskWidgetPaintAllocations);
+				}
+				ClipRenderData->Update(Parameters, PaintClips, GSize);
+			}
+			else
+			{
+				for (uint8 i = 0; i < LEGACY_MASK_CLIP_COUNT; i++)
+				{
+					if (i < PaintClips.Num())
+					{
+						const FMaskClipPaintData& Clip = PaintClips[i];
+						const bool bAnalytic = Clip.ShapeType != EMaskClipShapeType::Texture;
+						if (Clip.bPending || bAnalytic)
+						{
+							// No cutout until its texture streamed in, none at all for analytic shapes
+							Parameters.SetMaskUV(i, FLinearColor(0.f, 0.f, 0.f, 0.f));
+						}
+						else if (Clip.IsDirty(EMaskClipDirty::Geometry | EMaskClipDirty::Shape))
+						{
+							Parameters.SetMaskUV(i, FLinearColor(Clip.Position.X / GSize.X, Clip.Position.Y / GSize.Y, Clip.Size.X / GSize.X, Clip.Size.Y / GSize.Y));
+						}
+						if (Clip.IsDirty(EMaskClipDirty::Texture | EMaskClipDirty::Shape) && (Clip.Texture || bAnalytic))
+						{
+							// Don't leave the previous MaskTex bound to a clip that became analytic
+							Parameters.SetMaskTex(i, Clip.Texture);
+						}
+					}
+					else if (i < PaintedClipCount)
+					{
+						Parameters.SetMaskUV(i, FLinearColor(0.f, 0.f, 0.f, 0.f));
+					}
+				}
+				MutableThis->PaintedClipCount = FMath::Min<int32>(PaintClips.Num(), LEGACY_MASK_CLIP_COUNT);
+			}
+
+			bool bAtlasPending = false;
+			for (int32 i = 0; i < PaintClips.Num(); i++)
+			{
+				// Mask images whose resource wasn't ready get their AtlasUV once FMaskAtlas drew them
+				FMaskClipPaintData& Clip = PaintClips[i];
+				const bool bTilePending = Parameters.SupportsClipData() && ClipRenderData->IsAtlasTilePending(i, Clip.Texture);
+				Clip.DirtyFlags = bTilePending ? EMaskClipDirty::Texture : EMaskClipDirty::None;
+				bAtlasPending |= bTilePending;
+			}
+			if (bAtlasPending && !AtlasTileTimer.IsValid())
+			{
+				// Nothing else repaints a widget under an invalidation panel
+				MutableThis->AtlasTileTimer = MutableThis->RegisterActiveTimer(0.f, FWidgetActiveTimerDelegate::CreateSP(MutableThis, &SMaskWidget::WaitForAtlasTiles));
+			}
+		}
+
+		if (!Parameters.SupportsClipData())
+		{
+			DrawnClipCount = LEGACY_MASK_CLIP_COUNT;
+		}
+		else if (ClipRenderData.IsValid())
+		{
+			DrawnClipCount = ClipRenderData->GetClipCapacity();
+			bDrawsAnalyticShapes = true;
+		}
+
+		UTexture* BgTex = Cast<UTexture>(CurBgImage->GetResourceObject());
+		if (PaintedBgTex.Get() != BgTex)
+		{
+			Parameters.SetBgTex(BgTex);
+			MutableThis->PaintedBgTex = BgTex;
+		}
+	}
+
+	// Until the mask material streamed in the background is drawn without any cutout
+	FSlateDrawElement::MakeBox(
+		OutDrawElements,
+		RetLayerId++,
+		AllottedGeometry.ToPaintGeometry(),
+		MatBrush->GetResourceObject() ? MatBrush : CurBgImage,
+		ESlateDrawEffect::None,
+		InWidgetStyle.GetColorAndOpacityTint() *
+		BgColorAndOpacity.Get().GetColor(InWidgetStyle) * CurBgImage->GetTint(InWidgetStyle)
+	);
+
+	// ClickClip states live as long as the widget, the grid keeps one per clip index
+	FHittestGrid& HittestGrid = Args.GetHittestGrid();
+	TArray<TSharedPtr<FSlateClickClippingState>>& ClickClips = MutableThis->ClickClipStates;
+	// SWidget::Paint only adds hit test visible widgets to the grid, the others have no clip to register
+	const bool bHitTestVisible = Args.GetInheritedHittestability() && GetVisibility().IsHitTestVisible();
+	const int32 ClickClipCount = bHitTestVisible ? FMath::Min<int32>(PaintClips.Num(), DrawnClipCount) : 0;
+	for (int32 i = 0; i < ClickClipCount; i++)
+	{
+		const FMaskClipPaintData& Clip = PaintClips[i];
+		if (Clip.bEnabled && (bDrawsAnalyticShapes || Clip.ShapeType == EMaskClipShapeType::Texture))
+		{
+			FGeometry MaskGeometry = AllottedGeometry.MakeChild(Clip.Position, Clip.Size, 1.f);
+			if (i >= ClickClips.Num())
+			{
+				const int32 PreviousMax = ClickClips.Max();
+				ClickClips.SetNum(i + 1);
+				if (ClickClips.Max() != PreviousMax)
+				{
+					INC_DWORD_STAT(STAT_MaskWidgetPaintAllocations);
+				}
+			}
+			if (ClickClips[i].IsValid())
+			{
+				ClickClips[i]->SetGeometry(MaskGeometry);
+			}
+			else
+			{
+				ClickClips[i] = MakeShareable(new FSlateClickClippingState(i, MaskGeometry, FOnClickClipClicked::CreateSP(SharedThis(MutableThis), &SMaskWidget::OnClickClipClicked)));
+				INC_DWORD_STAT(STAT_MaskWidgetPaintAllocations);
+			}
+			HittestGrid.AddClickClip(this, ClickClips[i]);
+		}
+		else if (i < RegisteredClickClipCount)
+		{
+			HittestGrid.RemoveClickClip(this, i);
+		}
+	}
+
+	// Clips removed or no longer drawn since the last paint
+	for (int32 i = ClickClipCount; i < RegisteredClickClipCount; i++)
+	{
+		HittestGrid.RemoveClickClip(this, i);
+	}
+	MutableThis->RegisteredClickClipCount = ClickClipCount;
+
+	return RetLayerId;
+}
+
+bool SMaskWidget::OnClickClipClicked(const FVector2D& HitUVInMask, const int32& ClipIndex)
+{
+	bool bThroughMask = false;
+
+	const FMaskClipShape* Shape = Style->GetMaskShapeByIdx(ClipIndex);
+	const FMaskHitTestBitmap* HitTestBitmap = Shape && !Shape->IsAnalytic() ? GetHitTestBitmapByIndex(ClipIndex) : nullptr;
+	if (HitTestBitmap)
+	{
+		bThroughMask = HitTestBitmap->IsClickThrough(HitUVInMask);
+	}
+	else if (Shape)
+	{
+		// Same outline the material draws
+		bThroughMask = Shape->IsInside(HitUVInMask, Style->MaskClips[ClipIndex].GetSize());
+	}
+
+// 移动设备没有Hover，此时触发可以认为是OnClick
+// 触发OnClicked是为了给用户一个比较方便的方法处理MaskWidget被点击了
+#if PLATFORM_IOS || PLATFORM_ANDROID
+	if (OnClicked.IsBound())
+	{
+		OnClicked.Execute(ClipIndex, bThroughMask);
+	}
+#endif
+
+	return bThroughMask;
+}
+
+FVector2D SMaskWidget::ComputeDesiredSize(float) const
+{
+	return GetBackgroundImage()->ImageSize;
+}
+
+FReply SMaskWidget::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (OnClicked.IsBound())
+	{
+		return OnClicked.Execute(-1, false);
+	}
+	return FReply::Handled();
+}
+
+FReply SMaskWidget::OnTouchGesture(const FGeometry& MyGeometry, const FPointerEvent& GestureEvent)
+{
+	if (OnClicked.IsBound())
+	{
+		return OnClicked.Execute(-1, false);
+	}
+	return FReply::Handled();
+}
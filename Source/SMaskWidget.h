@@ -1,120 +1,223 @@
-// MIT License
-
-// Copyright (c) 2021 HankShu inkiu0@gmail.com
-
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
-
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
-
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "MaskSlateStyle.h"
-#include "Styling/CoreStyle.h"
-#include "Widgets/SLeafWidget.h"
-#include "Materials/MaterialInterface.h"
-#include "Widgets/DeclarativeSyntaxSupport.h"
-#include "Materials/MaterialInstanceDynamic.h"
-
-class FPaintArgs;
-class FSlateWindowElementList;
-
-DECLARE_DELEGATE_RetVal_TwoParams(FReply, FMaskOnClicked,
-const int32&,
-const bool&)
-
-UENUM()
-enum class EEaseMode : uint8
-{
-	LinearIn,
-	QuadEaseIn,
-	QuadEaseOut,
-	CubicEaseIn,
-	CubicEaseOut
-};
-
-class MMOGAME_API SMaskWidget : public SLeafWidget
-{
-public:
-	SLATE_BEGIN_ARGS(SMaskWidget)
-		: _Style(&FCoreStyle::Get().GetWidgetStyle<FMaskWidgetStyle>("MaskWidget"))
-		, _BgColorAndOpacity(FLinearColor::White)
-		{
-			_Visibility = EVisibility::Visible;
-		}
-
-		SLATE_STYLE_ARGUMENT(FMaskWidgetStyle, Style)
-
-		/** 颜色和透明度 */
-		SLATE_ATTRIBUTE(FSlateColor, BgColorAndOpacity)
-
-	SLATE_END_ARGS()
-
-	void Construct(const FArguments& InArgs);
-
-	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
-	virtual FVector2D ComputeDesiredSize(float) const override;
-	virtual bool IsInteractable() const override;
-
-	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
-
-	virtual FReply OnTouchGesture(const FGeometry& MyGeometry, const FPointerEvent& GestureEvent) override;
-
-	/** 设置背景的颜色和透明度 */
-	void SetBgColorAndOpacity(const TAttribute<FSlateColor>& InColorAndOpacity);
-
-	/** 设置背景的颜色和透明度 */
-	void SetBgColorAndOpacity(FLinearColor InColorAndOpacity);
-
-	/** See attribute Style */
-	void SetStyle(const FMaskWidgetStyle* InStyle);
-
-	/** Set ClickClip's MaskPosition */
-	void SetMaskPosition(const int32& ClipIndex, TAttribute<FVector2D> InMaskPosition);
-
-	/** See attribute BackgroundImage */
-	void SetBackgroundImage(const FSlateBrush* InBackgroundImage);
-
-	void ReIndexClip();
-
-private:
-
-	const FSlateBrush* GetBackgroundImage() const;
-
-	const UTexture2D* GetMaskTextureByIndex(const int32& Index) const;
-
-	const FSlateBrush* GetMaskMatBrush() const;
-
-	bool OnClickClipClicked(const FVector2D& Point, const int32& ClipIndex);
-
-public:
-
-	bool IsMaskUpdated = true;
-
-protected:
-
-	FMaskOnClicked OnClicked;
-
-	/** 背景图片的颜色和透明度比例 */
-	TAttribute<FSlateColor> BgColorAndOpacity;
-
-	const FSlateBrush* BackgroundImage;
-
-private:
-
-	FMaskWidgetStyle* Style;
-};
+// MIT License
+
+// Copyright (c) 2021 HankShu inkiu0@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaskSlateStyle.h"
+#include "Styling/CoreStyle.h"
+#include "Widgets/SLeafWidget.h"
+#include "Materials/MaterialInterface.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "MaskClipRenderData.h"
+#include "MaskMaterialParameters.h"
+#include "SMaskWidget.generated.h"
+
+class FPaintArgs;
+class FActiveTimerHandle;
+struct FStreamableHandle;
+class FSlateClickClippingState;
+class FSlateWindowElementList;
+
+DECLARE_DELEGATE_RetVal_TwoParams(FReply, FMaskOnClicked,
+const int32&,
+const bool&)
+
+/** Easing of a clip animation, see SMaskWidget::AnimateClip */
+UENUM(BlueprintType)
+enum class EEaseMode : uint8
+{
+	LinearIn,
+	QuadEaseIn,
+	QuadEaseOut,
+	CubicEaseIn,
+	CubicEaseOut
+};
+
+class MMOGAME_API SMaskWidget : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SMaskWidget)
+		: _Style(&FCoreStyle::Get().GetWidgetStyle<FMaskWidgetStyle>("MaskWidget"))
+		, _BgColorAndOpacity(FLinearColor::White)
+		{
+			_Visibility = EVisibility::Visible;
+		}
+
+		SLATE_STYLE_ARGUMENT(FMaskWidgetStyle, Style)
+
+		/** 颜色和透明度 */
+		SLATE_ATTRIBUTE(FSlateColor, BgColorAndOpacity)
+
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	virtual ~SMaskWidget();
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float) const override;
+	virtual bool IsInteractable() const override;
+
+	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+
+	virtual FReply OnTouchGesture(const FGeometry& MyGeometry, const FPointerEvent& GestureEvent) override;
+
+	/** 设置背景的颜色和透明度 */
+	void SetBgColorAndOpacity(const TAttribute<FSlateColor>& InColorAndOpacity);
+
+	/** 设置背景的颜色和透明度 */
+	void SetBgColorAndOpacity(FLinearColor InColorAndOpacity);
+
+	/** See attribute Style, InvalidateReason is added to the Paint or Layout invalidation the style's ImageSize needs */
+	void SetStyle(const FMaskWidgetStyle* InStyle, EInvalidateWidgetReason InvalidateReason = EInvalidateWidgetReason::Paint);
+
+	/** Set ClickClip's MaskPosition */
+	void SetMaskPosition(const int32& ClipIndex, TAttribute<FVector2D> InMaskPosition);
+
+	/** See attribute BackgroundImage */
+	void SetBackgroundImage(const FSlateBrush* InBackgroundImage);
+
+	void ReIndexClip();
+
+	/**
+	 * Move and resize a clip to TargetPosition / TargetSize over Duration seconds, replacing its running animation.
+	 * Runs on an active timer and only invalidates paint, the clip's material parameters and ClickClip follow every frame.
+	 */
+	void AnimateClip(int32 ClipIndex, const FVector2D& TargetPosition, const FVector2D& TargetSize, float Duration, EEaseMode EaseMode);
+
+	/** Stop the clip's animation where it is */
+	void StopClipAnimation(int32 ClipIndex);
+
+	bool IsClipAnimating(int32 ClipIndex) const;
+
+	/** The clip at ClipIndex was removed from the style, following clips moved down a slot */
+	void OnClipRemoved(int32 ClipIndex);
+
+private:
+
+	/** Active timer repainting the widget once the atlas drew the mask images it was waiting for */
+	EActiveTimerReturnType WaitForAtlasTiles(double InCurrentTime, float InDeltaTime);
+
+	/** Active timer of the clip animations, stops itself once none is left */
+	EActiveTimerReturnType UpdateClipAnimations(double InCurrentTime, float InDeltaTime);
+
+	static float EvaluateEase(EEaseMode EaseMode, float Alpha);
+
+	/** Layout when the background ImageSize changed since the last call, Paint otherwise */
+	EInvalidateWidgetReason GetDesiredSizeInvalidateReason();
+
+	const FSlateBrush* GetBackgroundImage() const;
+
+	const UTexture2D* GetMaskTextureByIndex(const int32& Index) const;
+
+	const FMaskHitTestBitmap* GetHitTestBitmapByIndex(const int32& Index) const;
+
+	const FSlateBrush* GetMaskMatBrush() const;
+
+	/** Stream in the mask textures of pending clips that aren't requested yet */
+	void RequestMaskTextures();
+
+	/** The mask material or a mask texture streamed in */
+	void OnMaskAssetsLoaded();
+
+	/** Release the streamed textures no clip references anymore */
+	void ReleaseUnusedMaskTextures();
+
+	bool OnClickClipClicked(const FVector2D& Point, const int32& ClipIndex);
+
+	/** Push Flags of every painted clip to the material on the next paint */
+	void MarkPaintClipsDirty(EMaskClipDirty Flags);
+
+public:
+
+	bool IsMaskUpdated = true;
+
+protected:
+
+	FMaskOnClicked OnClicked;
+
+	/** 背景图片的颜色和透明度比例 */
+	TAttribute<FSlateColor> BgColorAndOpacity;
+
+	const FSlateBrush* BackgroundImage = nullptr;
+
+private:
+
+	FMaskWidgetStyle* Style;
+
+	/** Parameters of the material instance this widget paints with */
+	FMaskMaterialParameters MaterialParameters;
+
+	/** Clips as painted, gathered from the style when it changes */
+	FMaskClipPaintArray PaintClips;
+
+	/** ClickClip state of each clip, updated in place and registered to the hittest grid every paint */
+	TArray<TSharedPtr<FSlateClickClippingState>> ClickClipStates;
+
+	/** Clips registered to the hittest grid on the last paint */
+	int32 RegisteredClickClipCount = 0;
+
+	/** Background ImageSize the desired size was last invalidated for */
+	FVector2D DesiredImageSize = FVector2D::ZeroVector;
+
+	/** Size the clips were normalized to on the last paint */
+	FVector2D PaintedGeometrySize = FVector2D::ZeroVector;
+
+	/** BgTex last pushed to the material */
+	TWeakObjectPtr<UTexture> PaintedBgTex;
+
+	/** MaskUV_%d slots holding a clip, the rest are zeroed once */
+	int32 PaintedClipCount = 0;
+
+	/** Draws the mask material instance, acquired from FMaskMaterialPool on first paint and released with the widget */
+	FSlateBrush MaskMatBrush;
+
+	/** Bound to FMaskMaterialPool::OnMaskMaterialLoaded while no instance could be acquired */
+	FDelegateHandle MaskMaterialLoadedHandle;
+
+	/** Mask textures streamed for this widget, one handle per path while a clip references it */
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> MaskTextureHandles;
+
+	/** ClipData / MaskAtlas of materials that draw any number of clips, created on first paint */
+	TUniquePtr<FMaskClipRenderData> ClipRenderData;
+
+	struct FClipAnimation
+	{
+		int32 ClipIndex;
+		FVector2D StartPosition;
+		FVector2D StartSize;
+		FVector2D TargetPosition;
+		FVector2D TargetSize;
+		float Duration;
+		float Elapsed;
+		EEaseMode EaseMode;
+	};
+
+	/** Running clip animations, one per clip */
+	TArray<FClipAnimation, TInlineAllocator<4>> ClipAnimations;
+
+	TSharedPtr<FActiveTimerHandle> ClipAnimationTimer;
+
+	TSharedPtr<FActiveTimerHandle> AtlasTileTimer;
+};
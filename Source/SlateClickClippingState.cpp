@@ -1,36 +1,44 @@
-#include "Layout/SlateClickClippingState.h"
-
-FSlateClickClippingState::FSlateClickClippingState(const int32& Index, const FGeometry& Geometry, FOnClickClipClicked InOnClicked)
-{
-	ClipIndex = Index;
-	DrawGeometry = Geometry;
-	OnClicked = InOnClicked;
-}
-
-bool FSlateClickClippingState::IsPointInside(const FVector2D& Point) const
-{
-	FVector2D HitUVInMask = DrawGeometry.AbsoluteToLocal(Point) / DrawGeometry.GetLocalSize();
-	if (HitUVInMask.X >= 0 && HitUVInMask.X <= 1 &&
-		HitUVInMask.Y >= 0 && HitUVInMask.Y <= 1)
-	{
-		return true;
-	}
-
-	return false;
-}
-
-bool FSlateClickClippingState::IsClickThrough(const FVector2D& Point) const
-{
-	bool bThroughMask = false;
-	FVector2D HitUVInMask = DrawGeometry.AbsoluteToLocal(Point) / DrawGeometry.GetLocalSize();
-	if (HitUVInMask.X >= 0 && HitUVInMask.X <= 1 &&
-		HitUVInMask.Y >= 0 && HitUVInMask.Y <= 1)
-	{
-		if (OnClicked.IsBound())
-		{
-			return OnClicked.Execute(HitUVInMask, ClipIndex);
-		}
-	}
-
-	return bThroughMask;
-}
+#include "Layout/SlateClickClippingState.h"
+
+FSlateClickClippingState::FSlateClickClippingState(const int32& Index, const FGeometry& Geometry, FOnClickClipClicked InOnClicked)
+{
+	ClipIndex = Index;
+	OnClicked = InOnClicked;
+	SetGeometry(Geometry);
+}
+
+void FSlateClickClippingState::SetGeometry(const FGeometry& Geometry)
+{
+	InverseRenderTransform = Inverse(Geometry.GetAccumulatedRenderTransform());
+
+	const FVector2D LocalSize = Geometry.GetLocalSize();
+	InverseLocalSize.X = LocalSize.X > 0 ? 1.0f / LocalSize.X : 0.0f;
+	InverseLocalSize.Y = LocalSize.Y > 0 ? 1.0f / LocalSize.Y : 0.0f;
+}
+
+bool FSlateClickClippingState::AbsoluteToUV(const FVector2D& Point, FVector2D& OutUV) const
+{
+	if (InverseLocalSize.X == 0 || InverseLocalSize.Y == 0)
+	{
+		return false;
+	}
+
+	OutUV = TransformPoint(InverseRenderTransform, Point) * InverseLocalSize;
+	return OutUV.X >= 0 && OutUV.X <= 1 &&
+		OutUV.Y >= 0 && OutUV.Y <= 1;
+}
+
+EClickClipHit FSlateClickClippingState::Classify(const FVector2D& Point) const
+{
+	FVector2D HitUVInMask;
+	if (!AbsoluteToUV(Point, HitUVInMask))
+	{
+		return EClickClipHit::Outside;
+	}
+
+	if (OnClicked.IsBound() && OnClicked.Execute(HitUVInMask, ClipIndex))
+	{
+		return EClickClipHit::InsideThrough;
+	}
+	return EClickClipHit::InsideBlocked;
+}
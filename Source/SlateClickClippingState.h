@@ -1,26 +1,58 @@
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Geometry.h"
-
-DECLARE_DELEGATE_RetVal_TwoParams(bool, FOnClickClipClicked,
-const FVector2D&,
-const int32&)
-
-class SLATECORE_API FSlateClickClippingState
-{
-public:
-	FSlateClickClippingState(const int32& Index, const FGeometry& Geometry, FOnClickClipClicked InOnClicked);
-
-	bool IsPointInside(const FVector2D& Point) const;
-
-	bool IsClickThrough(const FVector2D& Point) const;
-
-private:
-
-	int32 ClipIndex = -1;
-
-	FGeometry DrawGeometry;
-
-	FOnClickClipClicked OnClicked;
-};
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Geometry.h"
+#include "Stats/Stats.h"
+
+/** Containers grown and states created while painting mask widgets, by SMaskWidget and by the hit test grid's ClickClips */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("MaskWidget Paint Allocations"), STAT_MaskWidgetPaintAllocations, STATGROUP_Slate, MMOGAME_API);
+
+DECLARE_DELEGATE_RetVal_TwoParams(bool, FOnClickClipClicked,
+const FVector2D&,
+const int32&)
+
+/** Where a point falls relative to a ClickClip */
+enum class EClickClipHit : uint8
+{
+	Outside,
+	InsideBlocked,
+	InsideThrough,
+};
+
+class SLATECORE_API FSlateClickClippingState
+{
+public:
+	FSlateClickClippingState(const int32& Index, const FGeometry& Geometry, FOnClickClipClicked InOnClicked);
+
+	/** Refresh the clip's geometry in place, the state is kept across paints */
+	void SetGeometry(const FGeometry& Geometry);
+
+	int32 GetClipIndex() const { return ClipIndex; }
+
+	/** Inside test and click through test in one absolute to local transform */
+	EClickClipHit Classify(const FVector2D& Point) const;
+
+	/** Pure geometric test, never runs OnClicked */
+	bool IsPointInside(const FVector2D& Point) const
+	{
+		FVector2D HitUVInMask;
+		return AbsoluteToUV(Point, HitUVInMask);
+	}
+
+	bool IsClickThrough(const FVector2D& Point) const { return Classify(Point) == EClickClipHit::InsideThrough; }
+
+private:
+
+	/** Absolute point to UV in the clip, false when the point is outside */
+	bool AbsoluteToUV(const FVector2D& Point, FVector2D& OutUV) const;
+
+	int32 ClipIndex = -1;
+
+	/** Inverse of the accumulated render transform, cached when the geometry is set */
+	FSlateRenderTransform InverseRenderTransform;
+
+	/** 1 / local size, zero for an empty clip */
+	FVector2D InverseLocalSize = FVector2D::ZeroVector;
+
+	FOnClickClipClicked OnClicked;
+};